@@ -0,0 +1,184 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Micro-benchmark harness shared by the bench_*.c programs. Each case is
+// run for BENCH_WARMUP_SAMPLES untimed samples, then BENCH_SAMPLES timed
+// ones; a sample times `batch` operations with the TSC, fenced so the
+// measured code cannot leak out of the window, and the timer's own cost
+// is subtracted. Percentiles are over the per-op time of each sample.
+//
+// The calling thread is pinned to CPU $BENCH_CPU (default 0). When
+// $BENCH_JSON_DIR is set, results also go to <dir>/<suite>.json for
+// comparing runs; make bench sets it to build/bench-results.
+//
+// Needs _GNU_SOURCE for sched_setaffinity; define it before any include.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sched.h>
+#include "timestamp.h"
+
+#define BENCH_WARMUP_SAMPLES 200
+#define BENCH_SAMPLES        5000
+#define BENCH_PATH_LEN       256
+
+// Runs `batch` operations; prepare, if set, runs untimed before each sample
+typedef void (*bench_fn_t)(void* ctx, uint32_t batch);
+
+typedef struct {
+    const char* name;
+    const char* param_name;  // what the sweep varies, e.g. "tasks"
+    uint32_t param;
+    uint32_t batch;
+    bench_fn_t run;
+    bench_fn_t prepare;
+    void* ctx;
+} bench_case_t;
+
+typedef struct {
+    double mean_ns;
+    double min_ns;
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+} bench_result_t;
+
+typedef struct {
+    const char* suite;
+    FILE* json;
+    uint32_t results;
+    uint64_t overhead_ticks;
+    double samples[BENCH_SAMPLES];
+} bench_t;
+
+static inline uint64_t bench_ticks_begin(void) {
+#if TIMESTAMP_HAS_TSC
+    __builtin_ia32_lfence();
+#endif
+    return timestamp_now_ticks();
+}
+
+static inline uint64_t bench_ticks_end(void) {
+#if TIMESTAMP_HAS_TSC
+    unsigned int aux;
+    uint64_t ticks = __builtin_ia32_rdtscp(&aux);
+    __builtin_ia32_lfence();
+    return ticks;
+#else
+    return timestamp_now_ticks();
+#endif
+}
+
+static inline bool bench_pin_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+static inline int bench_compare(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static inline double bench_percentile(const double* sorted, uint32_t count, double percentile) {
+    uint32_t index = (uint32_t)(percentile / 100.0 * (count - 1) + 0.5);
+    return sorted[index];
+}
+
+static inline bool bench_init(bench_t* bench, const char* suite) {
+    memset(bench, 0, sizeof(*bench));
+    bench->suite = suite;
+    timestamp_init();
+    
+    const char* cpu = getenv("BENCH_CPU");
+    if (!bench_pin_cpu(cpu ? atoi(cpu) : 0)) {
+        fprintf(stderr, "%s: cannot pin to CPU %s, timings will be noisier\n",
+                suite, cpu ? cpu : "0");
+    }
+    
+    // Cheapest of many empty windows is the timer's own cost
+    bench->overhead_ticks = UINT64_MAX;
+    for (uint32_t i = 0; i < 1000; i++) {
+        uint64_t start = bench_ticks_begin();
+        uint64_t ticks = bench_ticks_end() - start;
+        if (ticks < bench->overhead_ticks) {
+            bench->overhead_ticks = ticks;
+        }
+    }
+    
+    const char* dir = getenv("BENCH_JSON_DIR");
+    if (dir) {
+        char path[BENCH_PATH_LEN];
+        snprintf(path, sizeof(path), "%s/%s.json", dir, suite);
+        bench->json = fopen(path, "w");
+        if (!bench->json) {
+            perror(path);
+            return false;
+        }
+        fprintf(bench->json, "{\"suite\":\"%s\",\"samples\":%u,\"results\":[", suite, BENCH_SAMPLES);
+    }
+    
+    printf("%-24s %-8s %8s %10s %10s %10s %10s %10s\n", "operation", "param", "value",
+           "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+    return true;
+}
+
+static inline bench_result_t bench_run(bench_t* bench, const bench_case_t* c) {
+    bench_result_t result;
+    double sum = 0.0;
+    
+    for (uint32_t s = 0; s < BENCH_WARMUP_SAMPLES + BENCH_SAMPLES; s++) {
+        if (c->prepare) {
+            c->prepare(c->ctx, c->batch);
+        }
+        uint64_t start = bench_ticks_begin();
+        c->run(c->ctx, c->batch);
+        uint64_t ticks = bench_ticks_end() - start;
+        if (s < BENCH_WARMUP_SAMPLES) {
+            continue;
+        }
+    
+        ticks = ticks > bench->overhead_ticks ? ticks - bench->overhead_ticks : 0;
+        double ns = (double)timestamp_ticks_to_ns(ticks) / c->batch;
+        bench->samples[s - BENCH_WARMUP_SAMPLES] = ns;
+        sum += ns;
+    }
+    
+    qsort(bench->samples, BENCH_SAMPLES, sizeof(double), bench_compare);
+    result.mean_ns = sum / BENCH_SAMPLES;
+    result.min_ns = bench->samples[0];
+    result.p50_ns = bench_percentile(bench->samples, BENCH_SAMPLES, 50.0);
+    result.p90_ns = bench_percentile(bench->samples, BENCH_SAMPLES, 90.0);
+    result.p99_ns = bench_percentile(bench->samples, BENCH_SAMPLES, 99.0);
+    result.p999_ns = bench_percentile(bench->samples, BENCH_SAMPLES, 99.9);
+    result.max_ns = bench->samples[BENCH_SAMPLES - 1];
+    
+    printf("%-24s %-8s %8u %10.1f %10.1f %10.1f %10.1f %10.1f\n", c->name, c->param_name,
+           c->param, result.mean_ns, result.p50_ns, result.p99_ns, result.p999_ns, result.max_ns);
+    if (bench->json) {
+        fprintf(bench->json, "%s\n{\"name\":\"%s\",\"param\":\"%s\",\"value\":%u,"
+                "\"batch\":%u,\"mean_ns\":%.2f,\"min_ns\":%.2f,\"p50_ns\":%.2f,"
+                "\"p90_ns\":%.2f,\"p99_ns\":%.2f,\"p999_ns\":%.2f,\"max_ns\":%.2f}",
+                bench->results ? "," : "", c->name, c->param_name, c->param, c->batch,
+                result.mean_ns, result.min_ns, result.p50_ns, result.p90_ns, result.p99_ns,
+                result.p999_ns, result.max_ns);
+    }
+    bench->results++;
+    return result;
+}
+
+static inline void bench_finish(bench_t* bench) {
+    if (bench->json) {
+        fputs("\n]}\n", bench->json);
+        fclose(bench->json);
+        bench->json = NULL;
+    }
+}
+
+#endif // BENCH_H
@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "coroutine.h"
+#include "green_thread.h"
+#include "task_manager.h"
+#include "timestamp.h"
+
+#define CO_TASKS     1000000u
+#define THREAD_TASKS 10000u
+#define RESUMES      4u
+
+static green_sched_t sched;
+
+static co_status_t yield_co(co_task_t* co, void* arg) {
+    uint32_t* resumes = arg;
+    CO_BEGIN(co);
+    while (*resumes < RESUMES) {
+        (*resumes)++;
+        CO_YIELD(co);
+    }
+    CO_END(co);
+}
+
+static void yield_thread(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < RESUMES; i++) {
+        green_yield();
+    }
+}
+
+// Spawns tasks, then times one scheduler run over all of them
+static void bench_coroutines(uint32_t count) {
+    co_task_t* cos = malloc(count * sizeof(co_task_t));
+    uint32_t* resumes = calloc(count, sizeof(uint32_t));
+    task_manager_init_capacity(count);
+    green_sched_init(&sched);
+    
+    uint64_t start = timestamp_now_ns();
+    for (uint32_t i = 0; i < count; i++) {
+        task_create(i, "Co", 1, 0);
+        co_spawn(&sched, &cos[i], i, yield_co, &resumes[i]);
+    }
+    double spawn_ns = (double)(timestamp_now_ns() - start) / count;
+    
+    start = timestamp_now_ns();
+    green_sched_run(&sched);
+    double resume_ns = (double)(timestamp_now_ns() - start) / (count * (RESUMES + 1));
+    
+    printf("%-20s %7u %12.2f\n", "coroutine spawn", count, spawn_ns);
+    printf("%-20s %7u %12.2f\n", "coroutine resume", count, resume_ns);
+    green_sched_destroy(&sched);
+    free(resumes);
+    free(cos);
+}
+
+static void bench_threads(void) {
+    green_task_t* tasks = malloc(THREAD_TASKS * sizeof(green_task_t));
+    task_manager_init_capacity(THREAD_TASKS);
+    green_sched_init(&sched);
+    
+    uint64_t start = timestamp_now_ns();
+    for (uint32_t i = 0; i < THREAD_TASKS; i++) {
+        task_create(i, "Thread", 1, GREEN_MIN_STACK);
+        green_spawn(&sched, &tasks[i], i, yield_thread, NULL);
+    }
+    double spawn_ns = (double)(timestamp_now_ns() - start) / THREAD_TASKS;
+    
+    start = timestamp_now_ns();
+    green_sched_run(&sched);
+    double resume_ns = (double)(timestamp_now_ns() - start) / (THREAD_TASKS * (RESUMES + 1));
+    
+    printf("%-20s %7u %12.2f\n", "green thread spawn", THREAD_TASKS, spawn_ns);
+    printf("%-20s %7u %12.2f\n", "green thread switch", THREAD_TASKS, resume_ns);
+    green_sched_destroy(&sched);
+    free(tasks);
+}
+
+int main(void) {
+    printf("%-20s %7s %12s\n", "operation", "tasks", "ns/op");
+    bench_coroutines(THREAD_TASKS);
+    bench_coroutines(CO_TASKS);
+    bench_threads();
+    
+    // Per-task memory beyond the task record
+    printf("\n%-28s %8zu\n", "task record bytes", sizeof(task_t));
+    printf("%-28s %8zu\n", "coroutine bytes", sizeof(co_task_t));
+    printf("%-28s %8zu\n", "green thread bytes (min)", sizeof(green_task_t) + GREEN_MIN_STACK);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_manager.h"
+#include "timestamp.h"
+
+#define CREATE_OPS  100000u
+#define YIELD_OPS   20000u
+#define STACK_DEPTH 256
+
+static StackType_t stacks[2][STACK_DEPTH];
+static StaticTask_t tcbs[2];
+static volatile uint32_t yields = 0;
+
+static void idle_task(void* params) {
+    (void)params;
+    for (;;) {
+        vTaskDelay(portMAX_DELAY);
+    }
+}
+
+// Two equal-priority tasks hand the CPU back and forth until YIELD_OPS
+// switches have happened
+static void yield_task(void* params) {
+    (void)params;
+    while (yields < YIELD_OPS) {
+        yields++;
+        taskYIELD();
+    }
+    vTaskEndScheduler();
+}
+
+static double bench_create_delete(void) {
+    uint64_t start = timestamp_now_ns();
+    for (uint32_t i = 0; i < CREATE_OPS; i++) {
+        TaskHandle_t handle = xTaskCreateStatic(idle_task, "Bench", STACK_DEPTH, NULL,
+                                                1, stacks[0], &tcbs[0]);
+        vTaskDelete(handle);
+    }
+    return (double)(timestamp_now_ns() - start) / CREATE_OPS;
+}
+
+static double bench_yield(void) {
+    xTaskCreateStatic(yield_task, "PingA", STACK_DEPTH, NULL, 1, stacks[0], &tcbs[0]);
+    xTaskCreateStatic(yield_task, "PingB", STACK_DEPTH, NULL, 1, stacks[1], &tcbs[1]);
+    
+    uint64_t start = timestamp_now_ns();
+    vTaskStartScheduler();
+    double ns = (double)(timestamp_now_ns() - start) / yields;
+    
+    vTaskDelete((TaskHandle_t)&tcbs[0]);
+    vTaskDelete((TaskHandle_t)&tcbs[1]);
+    return ns;
+}
+
+int main(void) {
+    task_manager_init();
+    printf("%-28s %12s\n", "operation", "ns/op");
+    printf("%-28s %12.2f\n", "xTaskCreateStatic+vTaskDelete", bench_create_delete());
+    printf("%-28s %12.2f\n", "taskYIELD switch", bench_yield());
+    return 0;
+}
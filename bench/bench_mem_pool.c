@@ -0,0 +1,122 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bench.h"
+#include "mem_pool.h"
+
+#define CHURN_BATCH  64u
+#define WORKING_SET  1024u
+#define MAX_THREADS  4
+
+static const uint32_t thread_counts[] = { 1, MAX_THREADS };
+
+typedef void* (*alloc_fn)(size_t size);
+typedef void (*free_fn)(void* ptr);
+
+typedef struct {
+    alloc_fn alloc;
+    free_fn release;
+    uint32_t seed;
+    void* slots[WORKING_SET];
+} churn_ctx_t;
+
+// Contenders churn the same allocator on the other CPUs while the pinned
+// thread is measured
+typedef struct {
+    churn_ctx_t churn;
+    volatile bool stop;
+} contender_t;
+
+static cpu_set_t all_cpus;   // affinity before bench_init pins this thread
+
+// Size skewed towards small messages: 16..2048 bytes
+static size_t next_size(uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    uint32_t shift = (*seed >> 28) % 8;
+    return (size_t)16u << ((*seed >> 16) % (shift + 1));
+}
+
+static void churn_fill(churn_ctx_t* ctx, alloc_fn alloc, free_fn release, uint32_t seed) {
+    ctx->alloc = alloc;
+    ctx->release = release;
+    ctx->seed = seed;
+    for (uint32_t i = 0; i < WORKING_SET; i++) {
+        ctx->slots[i] = alloc(next_size(&ctx->seed));
+    }
+}
+
+static void churn_drain(churn_ctx_t* ctx) {
+    for (uint32_t i = 0; i < WORKING_SET; i++) {
+        ctx->release(ctx->slots[i]);
+    }
+}
+
+// Keeps WORKING_SET live blocks and replaces a random one per op, the
+// pattern of a message-passing layer that allocates per payload
+static void run_churn(void* arg, uint32_t batch) {
+    churn_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        uint32_t slot = (ctx->seed >> 8) % WORKING_SET;
+        ctx->release(ctx->slots[slot]);
+        ctx->slots[slot] = ctx->alloc(next_size(&ctx->seed));
+        *(volatile uint8_t*)ctx->slots[slot] = (uint8_t)i;
+    }
+}
+
+static void* contend(void* arg) {
+    contender_t* contender = arg;
+    sched_setaffinity(0, sizeof(all_cpus), &all_cpus);
+    while (!contender->stop) {
+        run_churn(&contender->churn, CHURN_BATCH);
+    }
+    return NULL;
+}
+
+static void run(bench_t* bench, const char* name, alloc_fn alloc, free_fn release,
+                uint32_t threads) {
+    pthread_t tids[MAX_THREADS];
+    contender_t* contenders = calloc(MAX_THREADS, sizeof(contender_t));
+    churn_ctx_t* ctx = malloc(sizeof(churn_ctx_t));
+    if (!contenders || !ctx) {
+        free(contenders);
+        free(ctx);
+        return;
+    }
+    
+    for (uint32_t t = 1; t < threads; t++) {
+        churn_fill(&contenders[t].churn, alloc, release, t + 1);
+        pthread_create(&tids[t], NULL, contend, &contenders[t]);
+    }
+    churn_fill(ctx, alloc, release, 1);
+    bench_case_t c = { name, "threads", threads, CHURN_BATCH, run_churn, NULL, ctx };
+    bench_run(bench, &c);
+    churn_drain(ctx);
+    
+    for (uint32_t t = 1; t < threads; t++) {
+        contenders[t].stop = true;
+        pthread_join(tids[t], NULL);
+        churn_drain(&contenders[t].churn);
+    }
+    free(contenders);
+    free(ctx);
+}
+
+int main(void) {
+    bench_t* bench = malloc(sizeof(bench_t));
+    sched_getaffinity(0, sizeof(all_cpus), &all_cpus);
+    if (!bench || !bench_init(bench, "mem_pool")) {
+        return 1;
+    }
+    
+    mem_pool_init();
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        run(bench, "malloc_churn", malloc, free, thread_counts[i]);
+        run(bench, "mem_pool_churn", mem_pool_alloc, mem_pool_free, thread_counts[i]);
+    }
+    
+    bench_finish(bench);
+    free(bench);
+    return 0;
+}
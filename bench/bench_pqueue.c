@@ -0,0 +1,94 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "pqueue.h"
+
+#define PAIR_BATCH    64u
+#define SWEEP_DEPTH   16u   // depth for the priority level sweep
+
+static const uint32_t depths[] = { 1, 16, 64, PQUEUE_MAX_SIZE - 1 };
+static const uint32_t levels[] = { 2, 8, PQUEUE_LEVELS };
+
+// Both queues are held at `depth` items; every op is one enqueue with a
+// pseudo-random priority in 0..levels-1 and one dequeue
+typedef struct {
+    pqueue_heap_t heap;
+    pqueue_bitmap_t bitmap;
+    uint32_t levels;
+    uint32_t seed;
+} pqueue_ctx_t;
+
+static volatile uint8_t sink;
+
+static uint32_t next_priority(pqueue_ctx_t* ctx) {
+    ctx->seed = ctx->seed * 1664525u + 1013904223u;
+    return (ctx->seed >> 16) % ctx->levels;
+}
+
+static void fill(pqueue_ctx_t* ctx, uint32_t depth, uint32_t level_count) {
+    ctx->levels = level_count;
+    ctx->seed = 1;
+    pqueue_heap_init(&ctx->heap, PQUEUE_MAX_SIZE);
+    pqueue_bitmap_init(&ctx->bitmap, PQUEUE_MAX_SIZE);
+    for (uint32_t i = 0; i < depth; i++) {
+        uint32_t priority = next_priority(ctx);
+        pqueue_heap_enqueue(&ctx->heap, (uint8_t)i, priority);
+        pqueue_bitmap_enqueue(&ctx->bitmap, (uint8_t)i, priority);
+    }
+}
+
+static void run_heap(void* arg, uint32_t batch) {
+    pqueue_ctx_t* ctx = arg;
+    uint8_t item;
+    for (uint32_t i = 0; i < batch; i++) {
+        pqueue_heap_enqueue(&ctx->heap, (uint8_t)i, next_priority(ctx));
+        pqueue_heap_dequeue(&ctx->heap, &item);
+        sink = item;
+    }
+}
+
+static void run_bitmap(void* arg, uint32_t batch) {
+    pqueue_ctx_t* ctx = arg;
+    uint8_t item;
+    for (uint32_t i = 0; i < batch; i++) {
+        pqueue_bitmap_enqueue(&ctx->bitmap, (uint8_t)i, next_priority(ctx));
+        pqueue_bitmap_dequeue(&ctx->bitmap, &item);
+        sink = item;
+    }
+}
+
+static void run_both(bench_t* bench, pqueue_ctx_t* ctx, const char* suffix,
+                     const char* param_name, uint32_t param) {
+    char heap_name[32];
+    char bitmap_name[32];
+    snprintf(heap_name, sizeof(heap_name), "pqueue_heap_%s", suffix);
+    snprintf(bitmap_name, sizeof(bitmap_name), "pqueue_bitmap_%s", suffix);
+    bench_case_t heap = { heap_name, param_name, param, PAIR_BATCH, run_heap, NULL, ctx };
+    bench_case_t bitmap = { bitmap_name, param_name, param, PAIR_BATCH, run_bitmap, NULL, ctx };
+    bench_run(bench, &heap);
+    bench_run(bench, &bitmap);
+}
+
+int main(void) {
+    bench_t* bench = malloc(sizeof(bench_t));
+    pqueue_ctx_t ctx;
+    if (!bench || !bench_init(bench, "pqueue")) {
+        return 1;
+    }
+    
+    // Depth sweep over all priority levels, then a level sweep at one depth
+    for (uint32_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+        fill(&ctx, depths[d], PQUEUE_LEVELS);
+        run_both(bench, &ctx, "pair", "depth", depths[d]);
+    }
+    for (uint32_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        fill(&ctx, SWEEP_DEPTH, levels[l]);
+        run_both(bench, &ctx, "levels", "levels", levels[l]);
+    }
+    
+    bench_finish(bench);
+    free(bench);
+    return 0;
+}
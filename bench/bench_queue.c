@@ -0,0 +1,109 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "queue.h"
+
+#define PAIR_BATCH 64u
+#define EDGE_BATCH 8u   // enqueues or dequeues per sample, from a set depth
+
+static const uint32_t pair_depths[] = { 0, 1, 8, 16, 31 };
+static const uint32_t edge_depths[] = { 0, 8, 16, 24 };
+static const uint32_t bulk_items[] = { 1, 8, 32 };
+
+typedef struct {
+    queue_t queue;
+    uint32_t depth;
+    uint32_t items;
+} queue_ctx_t;
+
+static void set_depth(queue_ctx_t* ctx, uint32_t depth) {
+    uint8_t item;
+    while (queue_size(&ctx->queue) > depth) {
+        queue_dequeue(&ctx->queue, &item);
+    }
+    while (queue_size(&ctx->queue) < depth) {
+        queue_enqueue(&ctx->queue, 0);
+    }
+}
+
+static void prepare_depth(void* arg, uint32_t batch) {
+    queue_ctx_t* ctx = arg;
+    (void)batch;
+    set_depth(ctx, ctx->depth);
+}
+
+// Keeps the queue at a constant depth: one enqueue and one dequeue per op
+static void run_pair(void* arg, uint32_t batch) {
+    queue_ctx_t* ctx = arg;
+    uint8_t item;
+    for (uint32_t i = 0; i < batch; i++) {
+        queue_enqueue(&ctx->queue, (uint8_t)i);
+        queue_dequeue(&ctx->queue, &item);
+    }
+}
+
+static void run_enqueue(void* arg, uint32_t batch) {
+    queue_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        queue_enqueue(&ctx->queue, (uint8_t)i);
+    }
+}
+
+static void run_dequeue(void* arg, uint32_t batch) {
+    queue_ctx_t* ctx = arg;
+    uint8_t item;
+    for (uint32_t i = 0; i < batch; i++) {
+        queue_dequeue(&ctx->queue, &item);
+    }
+}
+
+static void run_bulk(void* arg, uint32_t batch) {
+    queue_ctx_t* ctx = arg;
+    uint8_t items[QUEUE_MAX_SIZE] = { 0 };
+    for (uint32_t i = 0; i < batch; i++) {
+        queue_enqueue_bulk(&ctx->queue, items, ctx->items);
+        queue_dequeue_bulk(&ctx->queue, items, ctx->items);
+    }
+}
+
+int main(void) {
+    bench_t* bench = malloc(sizeof(bench_t));
+    queue_ctx_t ctx;
+    if (!bench || !bench_init(bench, "queue")) {
+        return 1;
+    }
+    queue_init(&ctx.queue, QUEUE_MAX_SIZE);
+    
+    for (uint32_t d = 0; d < sizeof(pair_depths) / sizeof(pair_depths[0]); d++) {
+        ctx.depth = pair_depths[d];
+        bench_case_t c = { "queue_enqueue_dequeue", "depth", ctx.depth, PAIR_BATCH,
+                           run_pair, prepare_depth, &ctx };
+        bench_run(bench, &c);
+    }
+    for (uint32_t d = 0; d < sizeof(edge_depths) / sizeof(edge_depths[0]); d++) {
+        ctx.depth = edge_depths[d];
+        bench_case_t c = { "queue_enqueue", "depth", ctx.depth, EDGE_BATCH,
+                           run_enqueue, prepare_depth, &ctx };
+        bench_run(bench, &c);
+    }
+    for (uint32_t d = 0; d < sizeof(edge_depths) / sizeof(edge_depths[0]); d++) {
+        ctx.depth = edge_depths[d] + EDGE_BATCH;
+        bench_case_t c = { "queue_dequeue", "depth", ctx.depth, EDGE_BATCH,
+                           run_dequeue, prepare_depth, &ctx };
+        bench_run(bench, &c);
+    }
+    
+    set_depth(&ctx, 0);
+    for (uint32_t b = 0; b < sizeof(bulk_items) / sizeof(bulk_items[0]); b++) {
+        ctx.items = bulk_items[b];
+        bench_case_t c = { "queue_bulk_pair", "items", ctx.items, PAIR_BATCH,
+                           run_bulk, NULL, &ctx };
+        bench_run(bench, &c);
+    }
+    
+    bench_finish(bench);
+    free(bench);
+    return 0;
+}
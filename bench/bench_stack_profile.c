@@ -0,0 +1,61 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "stack_profile.h"
+
+#define SCAN_BATCH 4u
+
+static uint8_t stack[65536] __attribute__((aligned(64)));
+static volatile uint32_t sink;
+
+typedef struct {
+    uint32_t size;
+} scan_ctx_t;
+
+// Byte-at-a-time scan, for comparison
+static uint32_t naive_unused(const uint8_t* p, uint32_t size) {
+    uint32_t n = 0;
+    while (n < size && p[n] == STACK_FILL_BYTE) {
+        n++;
+    }
+    return n;
+}
+
+static void run_naive(void* arg, uint32_t batch) {
+    scan_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        sink += naive_unused(stack, ctx->size);
+    }
+}
+
+static void run_vector(void* arg, uint32_t batch) {
+    scan_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        sink += stack_unused_bytes(stack, ctx->size);
+    }
+}
+
+int main(void) {
+    bench_t* bench = malloc(sizeof(bench_t));
+    scan_ctx_t ctx;
+    if (!bench || !bench_init(bench, "stack_profile")) {
+        return 1;
+    }
+    
+    // Untouched stacks: the whole buffer is scanned
+    for (ctx.size = 1024; ctx.size <= sizeof(stack); ctx.size *= 4) {
+        stack_paint(stack, ctx.size);
+        bench_case_t naive = { "stack_scan_byte_loop", "bytes", ctx.size, SCAN_BATCH,
+                               run_naive, NULL, &ctx };
+        bench_case_t vector = { "stack_unused_bytes", "bytes", ctx.size, SCAN_BATCH,
+                                run_vector, NULL, &ctx };
+        bench_run(bench, &naive);
+        bench_run(bench, &vector);
+    }
+    
+    bench_finish(bench);
+    free(bench);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "task_manager.h"
+
+#define BATCH     64u
+#define FIRST_ID  1u
+
+static const uint32_t table_sizes[] = { 16, 256, 4096, 65536 };
+
+// Tasks FIRST_ID.. fill the table but for a batch of free slots; probe
+// visits the live ids in a shuffled order so lookups miss the cache like
+// a real scheduler's would
+typedef struct {
+    uint32_t live;
+    uint32_t spare_id;       // first of BATCH ids kept free for create
+    uint32_t* probe;
+    uint32_t cursor;
+    uint32_t round;
+} task_ctx_t;
+
+static void shuffle(uint32_t* ids, uint32_t count) {
+    uint32_t seed = 12345;
+    for (uint32_t i = count - 1; i > 0; i--) {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t j = (seed >> 8) % (i + 1);
+        uint32_t tmp = ids[i];
+        ids[i] = ids[j];
+        ids[j] = tmp;
+    }
+}
+
+static void run_get(void* arg, uint32_t batch) {
+    task_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        task_t* volatile task = task_get(ctx->probe[ctx->cursor++ % ctx->live]);
+        (void)task;
+    }
+}
+
+static void run_set_state(void* arg, uint32_t batch) {
+    task_ctx_t* ctx = arg;
+    task_state_t state = (ctx->round++ & 1) ? TASK_READY : TASK_RUNNING;
+    for (uint32_t i = 0; i < batch; i++) {
+        task_set_state(ctx->probe[ctx->cursor++ % ctx->live], state);
+    }
+}
+
+static void run_create(void* arg, uint32_t batch) {
+    task_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        task_create(ctx->spare_id + i, "Bench", 1, 0);
+    }
+}
+
+static void run_delete(void* arg, uint32_t batch) {
+    task_ctx_t* ctx = arg;
+    for (uint32_t i = 0; i < batch; i++) {
+        task_delete(ctx->spare_id + i);
+    }
+}
+
+int main(void) {
+    bench_t* bench = malloc(sizeof(bench_t));
+    if (!bench || !bench_init(bench, "task_manager")) {
+        return 1;
+    }
+    
+    for (uint32_t s = 0; s < sizeof(table_sizes) / sizeof(table_sizes[0]); s++) {
+        uint32_t size = table_sizes[s];
+        uint32_t batch = BATCH < size / 2 ? BATCH : size / 2;
+        task_ctx_t ctx = { size - batch, FIRST_ID + size - batch, NULL, 0, 0 };
+        ctx.probe = malloc(ctx.live * sizeof(uint32_t));
+        if (!ctx.probe || !task_manager_init_capacity(size)) {
+            return 1;
+        }
+        for (uint32_t i = 0; i < ctx.live; i++) {
+            task_create(FIRST_ID + i, "Bench", 1, 0);
+            ctx.probe[i] = FIRST_ID + i;
+        }
+        shuffle(ctx.probe, ctx.live);
+    
+        bench_case_t cases[] = {
+            { "task_get", "tasks", size, batch, run_get, NULL, &ctx },
+            { "task_set_state", "tasks", size, batch, run_set_state, NULL, &ctx },
+            // prepare frees or recreates the spare ids before every sample
+            { "task_create", "tasks", size, batch, run_create, run_delete, &ctx },
+            { "task_delete", "tasks", size, batch, run_delete, run_create, &ctx },
+        };
+        for (uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            bench_run(bench, &cases[c]);
+        }
+        free(ctx.probe);
+    }
+    
+    bench_finish(bench);
+    task_manager_init();
+    free(bench);
+    return 0;
+}
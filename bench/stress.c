@@ -0,0 +1,464 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "queue.h"
+#include "task_manager.h"
+#include "timestamp.h"
+
+// Contention stress for queue.c and task_manager.c. Each thread runs a
+// random stream of operations drawn from a producer:consumer:reader:writer
+// mix for a fixed time:
+//   producer  enqueue on the thread's home queue, under that queue's mutex
+//   consumer  dequeue from the home queue, under that queue's mutex
+//   reader    task_get of a random task
+//   writer    task_set_state of a random task
+// Queues are shared round-robin (-q), so -q 1 is one hot queue and -q 0
+// gives every thread its own. The queues are laid out back to back
+// ("packed", neighbours share cache lines) or each in its own 128-byte
+// aligned block ("padded"), and running both shows what false sharing
+// costs.
+//
+// For each thread count it reports throughput, scaling against one
+// thread, sampled per-op latency percentiles, L1D and last-level cache
+// misses per op from perf_event_open, and the slowest thread's share.
+
+#define MAX_THREADS     64
+#define STRESS_TASKS    1024
+#define SAMPLE_MASK     15u      // time one op in 16
+#define MAX_SAMPLES     16384    // per thread, newest kept; power of two
+#define PADDED_STRIDE   128      // adjacent-line prefetch pairs 64 B lines
+
+typedef enum {
+    ROLE_PRODUCER,
+    ROLE_CONSUMER,
+    ROLE_READER,
+    ROLE_WRITER,
+    ROLE_COUNT
+} role_t;
+
+typedef enum {
+    LAYOUT_PACKED,
+    LAYOUT_PADDED
+} layout_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    queue_t queue;
+} shared_queue_t;
+
+typedef struct {
+    uint32_t thread_counts[MAX_THREADS];
+    uint32_t thread_count_n;
+    uint32_t weights[ROLE_COUNT];
+    uint32_t queues;             // 0: one per thread
+    bool layouts[2];
+    uint32_t duration_ms;
+    uint32_t seed;
+    const char* json_path;
+} stress_config_t;
+
+// Workers own their slot, so it is padded to keep the harness itself
+// free of false sharing
+typedef struct {
+    uint64_t ops;
+    uint64_t failed;             // enqueue on full or dequeue on empty
+    uint64_t sample_count;
+    uint64_t l1d_misses;
+    uint64_t llc_misses;
+    bool perf_ok;
+    uint32_t index;
+    uint32_t seed;
+    shared_queue_t* home;
+    uint64_t* samples;
+} __attribute__((aligned(PADDED_STRIDE))) worker_t;
+
+typedef struct {
+    double mops;
+    double scaling;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+    double l1d_per_op;           // negative when perf is unavailable
+    double llc_per_op;
+    double fairness;             // slowest thread's ops / fastest's
+} stress_result_t;
+
+static stress_config_t config;
+static worker_t workers[MAX_THREADS];
+static pthread_barrier_t start_barrier;
+static volatile bool stop = false;
+static uint32_t weight_total;
+
+static uint32_t next_random(uint32_t* seed) {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
+
+static int perf_open(uint32_t type, uint64_t event) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = event;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static uint64_t perf_stop(int fd) {
+    uint64_t count = 0;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+    }
+    close(fd);
+    return count;
+}
+
+static void run_op(worker_t* worker, role_t role) {
+    uint8_t item;
+    if (role == ROLE_PRODUCER) {
+        pthread_mutex_lock(&worker->home->lock);
+        worker->failed += !queue_enqueue(&worker->home->queue, (uint8_t)worker->ops);
+        pthread_mutex_unlock(&worker->home->lock);
+    } else if (role == ROLE_CONSUMER) {
+        pthread_mutex_lock(&worker->home->lock);
+        worker->failed += !queue_dequeue(&worker->home->queue, &item);
+        pthread_mutex_unlock(&worker->home->lock);
+    } else if (role == ROLE_READER) {
+        task_t* volatile task = task_get(1 + next_random(&worker->seed) % STRESS_TASKS);
+        (void)task;
+    } else {
+        uint32_t r = next_random(&worker->seed);
+        task_set_state(1 + r % STRESS_TASKS, (task_state_t)((r >> 16) % TASK_SUSPENDED));
+    }
+}
+
+static role_t pick_role(worker_t* worker) {
+    uint32_t r = next_random(&worker->seed) % weight_total;
+    role_t role = ROLE_PRODUCER;
+    while (r >= config.weights[role]) {
+        r -= config.weights[role];
+        role++;
+    }
+    return role;
+}
+
+static void* worker_main(void* arg) {
+    worker_t* worker = arg;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker->index % (uint32_t)sysconf(_SC_NPROCESSORS_ONLN), &set);
+    sched_setaffinity(0, sizeof(set), &set);
+    
+    int l1d = perf_open(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                        (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    int llc = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    worker->perf_ok = l1d >= 0 && llc >= 0;
+    
+    pthread_barrier_wait(&start_barrier);
+    if (worker->perf_ok) {
+        ioctl(l1d, PERF_EVENT_IOC_ENABLE, 0);
+        ioctl(llc, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+        role_t role = pick_role(worker);
+        if ((worker->ops & SAMPLE_MASK) == 0) {
+            uint64_t start = timestamp_now_ticks();
+            run_op(worker, role);
+            worker->samples[worker->sample_count++ & (MAX_SAMPLES - 1)] =
+                timestamp_now_ticks() - start;
+        } else {
+            run_op(worker, role);
+        }
+        worker->ops++;
+    }
+    
+    if (l1d >= 0) {
+        worker->l1d_misses = perf_stop(l1d);
+    }
+    if (llc >= 0) {
+        worker->llc_misses = perf_stop(llc);
+    }
+    return NULL;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t percentile(const uint64_t* sorted, uint64_t count, double p) {
+    return count ? sorted[(uint64_t)(p / 100.0 * (double)(count - 1) + 0.5)] : 0;
+}
+
+static bool run(uint32_t threads, layout_t layout, stress_result_t* result) {
+    uint32_t queue_count = config.queues ? config.queues : threads;
+    size_t padded = (sizeof(shared_queue_t) + PADDED_STRIDE - 1) / PADDED_STRIDE * PADDED_STRIDE;
+    size_t stride = layout == LAYOUT_PADDED ? padded : sizeof(shared_queue_t);
+    size_t bytes = (queue_count * stride + PADDED_STRIDE - 1) / PADDED_STRIDE * PADDED_STRIDE;
+    uint8_t* queues = aligned_alloc(PADDED_STRIDE, bytes);
+    uint64_t* samples = malloc((size_t)threads * MAX_SAMPLES * sizeof(uint64_t));
+    pthread_t tids[MAX_THREADS];
+    if (!queues || !samples) {
+        free(queues);
+        free(samples);
+        return false;
+    }
+    
+    for (uint32_t q = 0; q < queue_count; q++) {
+        shared_queue_t* shared = (shared_queue_t*)(queues + q * stride);
+        pthread_mutex_init(&shared->lock, NULL);
+        queue_init(&shared->queue, QUEUE_MAX_SIZE);
+    }
+    task_manager_init_capacity(STRESS_TASKS);
+    for (uint32_t id = 1; id <= STRESS_TASKS; id++) {
+        task_create(id, "Stress", id % 8, 0);
+    }
+    
+    stop = false;
+    pthread_barrier_init(&start_barrier, NULL, threads + 1);
+    for (uint32_t t = 0; t < threads; t++) {
+        worker_t* worker = &workers[t];
+        memset(worker, 0, sizeof(*worker));
+        worker->index = t;
+        worker->seed = config.seed + t * 7919u + 1;
+        worker->home = (shared_queue_t*)(queues + (t % queue_count) * stride);
+        worker->samples = samples + (size_t)t * MAX_SAMPLES;
+        pthread_create(&tids[t], NULL, worker_main, worker);
+    }
+    
+    pthread_barrier_wait(&start_barrier);
+    uint64_t start = timestamp_now_ns();
+    struct timespec duration = { config.duration_ms / 1000, (long)(config.duration_ms % 1000) * 1000000L };
+    nanosleep(&duration, NULL);
+    __atomic_store_n(&stop, true, __ATOMIC_RELAXED);
+    for (uint32_t t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    uint64_t elapsed = timestamp_now_ns() - start;
+    pthread_barrier_destroy(&start_barrier);
+    
+    // Gather: samples are compacted to the front before sorting
+    uint64_t ops = 0, l1d = 0, llc = 0, slowest = UINT64_MAX, fastest = 0, kept = 0;
+    bool perf_ok = true;
+    for (uint32_t t = 0; t < threads; t++) {
+        worker_t* worker = &workers[t];
+        uint64_t n = worker->sample_count < MAX_SAMPLES ? worker->sample_count : MAX_SAMPLES;
+        memmove(samples + kept, worker->samples, n * sizeof(uint64_t));
+        kept += n;
+        ops += worker->ops;
+        l1d += worker->l1d_misses;
+        llc += worker->llc_misses;
+        perf_ok = perf_ok && worker->perf_ok;
+        slowest = worker->ops < slowest ? worker->ops : slowest;
+        fastest = worker->ops > fastest ? worker->ops : fastest;
+    }
+    qsort(samples, kept, sizeof(uint64_t), compare_u64);
+    
+    result->mops = (double)ops * 1000.0 / (double)elapsed;
+    result->p50_ns = timestamp_ticks_to_ns(percentile(samples, kept, 50.0));
+    result->p99_ns = timestamp_ticks_to_ns(percentile(samples, kept, 99.0));
+    result->p999_ns = timestamp_ticks_to_ns(percentile(samples, kept, 99.9));
+    result->max_ns = kept ? timestamp_ticks_to_ns(samples[kept - 1]) : 0;
+    result->l1d_per_op = perf_ok && ops ? (double)l1d / (double)ops : -1.0;
+    result->llc_per_op = perf_ok && ops ? (double)llc / (double)ops : -1.0;
+    result->fairness = fastest ? (double)slowest / (double)fastest : 0.0;
+    
+    for (uint32_t q = 0; q < queue_count; q++) {
+        pthread_mutex_destroy(&((shared_queue_t*)(queues + q * stride))->lock);
+    }
+    free(queues);
+    free(samples);
+    return true;
+}
+
+// Parses "1,2,4" into counts, each 1..max; returns how many
+static uint32_t parse_list(const char* text, uint32_t* values, uint32_t max_values, uint32_t max) {
+    uint32_t n = 0;
+    char* end;
+    while (*text && n < max_values) {
+        unsigned long value = strtoul(text, &end, 10);
+        if (end == text || value == 0 || value > max) {
+            return 0;
+        }
+        values[n++] = (uint32_t)value;
+        text = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') {
+            return 0;
+        }
+    }
+    return n;
+}
+
+// Parses "p:c:r:w" weights
+static bool parse_mix(const char* text, uint32_t* weights) {
+    unsigned int w[ROLE_COUNT];
+    char tail;
+    if (sscanf(text, "%u:%u:%u:%u%c", &w[0], &w[1], &w[2], &w[3], &tail) != ROLE_COUNT) {
+        return false;
+    }
+    for (uint32_t r = 0; r < ROLE_COUNT; r++) {
+        weights[r] = w[r];
+    }
+    return w[0] + w[1] + w[2] + w[3] > 0;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [-t threads] [-m mix] [-q queues] [-l layout] [-d ms] [-s seed] [-j json]\n"
+            "  -t  thread counts, comma separated, 1..%d (default 1,2,4,8,16,32,64)\n"
+            "  -m  producer:consumer:reader:writer weights (default 1:1:1:1)\n"
+            "  -q  shared queues, 0 for one per thread (default 0)\n"
+            "  -l  packed, padded or both (default both)\n"
+            "  -d  duration of each run in ms (default 200)\n"
+            "  -s  random seed (default 1)\n"
+            "  -j  also write results as JSON to this file\n",
+            program, MAX_THREADS);
+}
+
+static bool parse_args(int argc, char** argv) {
+    static const uint32_t default_threads[] = { 1, 2, 4, 8, 16, 32, 64 };
+    memcpy(config.thread_counts, default_threads, sizeof(default_threads));
+    config.thread_count_n = sizeof(default_threads) / sizeof(default_threads[0]);
+    for (uint32_t r = 0; r < ROLE_COUNT; r++) {
+        config.weights[r] = 1;
+    }
+    config.layouts[LAYOUT_PACKED] = config.layouts[LAYOUT_PADDED] = true;
+    config.duration_ms = 200;
+    config.seed = 1;
+    
+    int opt;
+    while ((opt = getopt(argc, argv, "t:m:q:l:d:s:j:")) != -1) {
+        if (opt == 't') {
+            config.thread_count_n = parse_list(optarg, config.thread_counts, MAX_THREADS, MAX_THREADS);
+            if (config.thread_count_n == 0) {
+                return false;
+            }
+        } else if (opt == 'm') {
+            if (!parse_mix(optarg, config.weights)) {
+                return false;
+            }
+        } else if (opt == 'q') {
+            config.queues = (uint32_t)strtoul(optarg, NULL, 10);
+        } else if (opt == 'l') {
+            bool both = strcmp(optarg, "both") == 0;
+            config.layouts[LAYOUT_PACKED] = both || strcmp(optarg, "packed") == 0;
+            config.layouts[LAYOUT_PADDED] = both || strcmp(optarg, "padded") == 0;
+            if (!config.layouts[LAYOUT_PACKED] && !config.layouts[LAYOUT_PADDED]) {
+                return false;
+            }
+        } else if (opt == 'd') {
+            config.duration_ms = (uint32_t)strtoul(optarg, NULL, 10);
+        } else if (opt == 's') {
+            config.seed = (uint32_t)strtoul(optarg, NULL, 10);
+        } else if (opt == 'j') {
+            config.json_path = optarg;
+        } else {
+            return false;
+        }
+    }
+    return optind == argc && config.duration_ms > 0;
+}
+
+int main(int argc, char** argv) {
+    static const char* const layout_names[] = { "packed", "padded" };
+    if (!parse_args(argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+    for (uint32_t r = 0; r < ROLE_COUNT; r++) {
+        weight_total += config.weights[r];
+    }
+    timestamp_init();
+    
+    FILE* json = NULL;
+    if (config.json_path) {
+        json = fopen(config.json_path, "w");
+        if (!json) {
+            perror(config.json_path);
+            return 1;
+        }
+        fprintf(json, "{\"mix\":[%u,%u,%u,%u],\"queues\":%u,\"duration_ms\":%u,\"runs\":[",
+                config.weights[0], config.weights[1], config.weights[2], config.weights[3],
+                config.queues, config.duration_ms);
+    }
+    
+    printf("mix %u:%u:%u:%u (producer:consumer:reader:writer), %s queues, %u ms per run, %ld CPUs\n",
+           config.weights[0], config.weights[1], config.weights[2], config.weights[3],
+           config.queues ? "shared" : "per-thread", config.duration_ms,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-7s %7s %9s %8s %8s %8s %9s %9s %9s %9s %9s\n", "layout", "threads", "Mops/s",
+           "scaling", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "L1D/op", "LLC/op", "fairness");
+    
+    bool first = true;
+    for (uint32_t l = 0; l < 2; l++) {
+        if (!config.layouts[l]) {
+            continue;
+        }
+        double single = 0.0;
+        for (uint32_t i = 0; i < config.thread_count_n; i++) {
+            uint32_t threads = config.thread_counts[i];
+            stress_result_t result;
+            if (!run(threads, (layout_t)l, &result)) {
+                fprintf(stderr, "%s: out of memory\n", argv[0]);
+                return 1;
+            }
+            // Per-thread throughput relative to the first run of the layout
+            if (i == 0) {
+                single = result.mops / threads;
+            }
+            result.scaling = single > 0.0 ? result.mops / (single * threads) : 0.0;
+    
+            printf("%-7s %7u %9.2f %8.2f %8llu %8llu %9llu %9llu ", layout_names[l], threads,
+                   result.mops, result.scaling, (unsigned long long)result.p50_ns,
+                   (unsigned long long)result.p99_ns, (unsigned long long)result.p999_ns,
+                   (unsigned long long)result.max_ns);
+            if (result.l1d_per_op >= 0.0) {
+                printf("%9.3f %9.3f", result.l1d_per_op, result.llc_per_op);
+            } else {
+                printf("%9s %9s", "n/a", "n/a");
+            }
+            printf(" %9.2f\n", result.fairness);
+            fflush(stdout);
+    
+            if (json) {
+                fprintf(json, "%s\n{\"layout\":\"%s\",\"threads\":%u,\"mops\":%.3f,"
+                        "\"scaling\":%.3f,\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,"
+                        "\"max_ns\":%llu,\"l1d_misses_per_op\":%.4f,\"llc_misses_per_op\":%.4f,"
+                        "\"fairness\":%.3f}",
+                        first ? "" : ",", layout_names[l], threads, result.mops, result.scaling,
+                        (unsigned long long)result.p50_ns, (unsigned long long)result.p99_ns,
+                        (unsigned long long)result.p999_ns, (unsigned long long)result.max_ns,
+                        result.l1d_per_op, result.llc_per_op, result.fairness);
+            }
+            first = false;
+        }
+    }
+    
+    if (json) {
+        fputs("\n]}\n", json);
+        fclose(json);
+    }
+    if (!workers[0].perf_ok) {
+        printf("cache misses n/a: perf_event_open is unavailable "
+               "(check /proc/sys/kernel/perf_event_paranoid)\n");
+    }
+    task_manager_init();
+    return 0;
+}
@@ -0,0 +1,66 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Host-side stand-in for the FreeRTOS kernel headers, so code written
+// against the FreeRTOS task API builds and runs on Linux on top of the task
+// manager. Only the types and configuration used by that API are provided.
+// Every config value can be overridden with -D on the command line.
+
+#ifndef configMAX_PRIORITIES
+#define configMAX_PRIORITIES 7
+#endif
+
+#ifndef configMAX_TASK_NAME_LEN
+#define configMAX_TASK_NAME_LEN 16
+#endif
+
+#ifndef configTICK_RATE_HZ
+#define configTICK_RATE_HZ 1000
+#endif
+
+#ifndef configMINIMAL_STACK_SIZE
+#define configMINIMAL_STACK_SIZE 128
+#endif
+
+#ifndef configNUMBER_OF_CORES
+#define configNUMBER_OF_CORES 1
+#endif
+
+#define configSUPPORT_STATIC_ALLOCATION     1
+#define configSUPPORT_DYNAMIC_ALLOCATION    0
+#define configUSE_MUTEXES                   1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef size_t StackType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE  ((BaseType_t)1)
+#define pdFAIL  pdFALSE
+#define pdPASS  pdTRUE
+
+#define portMAX_DELAY      ((TickType_t)UINT32_MAX)
+#define portTICK_PERIOD_MS ((TickType_t)(1000 / configTICK_RATE_HZ))
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
+#define pdTICKS_TO_MS(t)   ((uint32_t)(((uint64_t)(t) * 1000u) / configTICK_RATE_HZ))
+
+// Opaque storage for a task control block, as in FreeRTOS. The real layout
+// is TCB_t in task.h; its size is checked against this at compile time.
+// ucontext_t makes the TCB much larger on the portable context switch.
+#if defined(__x86_64__) && !defined(GREEN_USE_UCONTEXT)
+#define FREERTOS_STATIC_TCB_SIZE 256
+#else
+#define FREERTOS_STATIC_TCB_SIZE 1536
+#endif
+
+typedef struct xSTATIC_TCB {
+    void* pxDummy1;
+    uint64_t uxDummy2[FREERTOS_STATIC_TCB_SIZE / sizeof(uint64_t)];
+} StaticTask_t;
+
+#endif // FREERTOS_H
@@ -0,0 +1,154 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "blocking_queue.h"
+#include "queue_set.h"
+#include "timeout.h"
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+static bool has_space(const void* ctx) {
+    return !queue_is_full((const queue_t*)ctx);
+}
+
+static bool has_items(const void* ctx) {
+    return !queue_is_empty((const queue_t*)ctx);
+}
+
+// Called with the lock held after a receive. The event loop may have read
+// the eventfd itself before receiving, so its counter says nothing about
+// what is left: an empty queue clears it (a read failing with EAGAIN is
+// fine), and items still queued make it readable again.
+static void event_rearm(blocking_queue_t* bq) {
+    if (bq->event_fd < 0) {
+        return;
+    }
+    uint64_t value = 1;
+    ssize_t rc;
+    if (queue_is_empty(&bq->queue)) {
+        rc = read(bq->event_fd, &value, sizeof(value));
+    } else {
+        rc = write(bq->event_fd, &value, sizeof(value));
+    }
+    (void)rc;
+}
+
+// Called with the lock held after an item was added. Only the empty to
+// non-empty transition writes, so a burst of sends costs one write.
+static void event_notify(blocking_queue_t* bq) {
+    if (bq->event_fd >= 0 && queue_size(&bq->queue) == 1) {
+        uint64_t one = 1;
+        ssize_t rc = write(bq->event_fd, &one, sizeof(one));
+        (void)rc;
+    }
+}
+
+bool blocking_queue_init(blocking_queue_t* bq, uint32_t size) {
+    if (!bq || size == 0 || size > QUEUE_MAX_SIZE) {
+        return false;
+    }
+    
+    queue_init(&bq->queue, size);
+    bq->set = NULL;
+    bq->event_fd = -1;
+    pthread_mutex_init(&bq->lock, NULL);
+    timeout_cond_init(&bq->not_empty);
+    timeout_cond_init(&bq->not_full);
+    return true;
+}
+
+void blocking_queue_destroy(blocking_queue_t* bq) {
+    if (bq) {
+        pthread_cond_destroy(&bq->not_empty);
+        pthread_cond_destroy(&bq->not_full);
+        pthread_mutex_destroy(&bq->lock);
+        if (bq->event_fd >= 0) {
+            close(bq->event_fd);
+            bq->event_fd = -1;
+        }
+    }
+}
+
+bool blocking_queue_send(blocking_queue_t* bq, uint8_t item, uint32_t timeout_ms) {
+    if (!bq) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&bq->lock);
+    bool sent = timeout_wait(&bq->not_full, &bq->lock, timeout_ms, has_space, &bq->queue) &&
+                queue_enqueue(&bq->queue, item);
+    if (sent) {
+        pthread_cond_signal(&bq->not_empty);
+        event_notify(bq);
+        if (bq->set) {
+            queue_set_post(bq->set, bq);
+        }
+    }
+    pthread_mutex_unlock(&bq->lock);
+    return sent;
+}
+
+bool blocking_queue_receive(blocking_queue_t* bq, uint8_t* item, uint32_t timeout_ms) {
+    if (!bq || !item) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&bq->lock);
+    bool received = timeout_wait(&bq->not_empty, &bq->lock, timeout_ms, has_items, &bq->queue) &&
+                    queue_dequeue(&bq->queue, item);
+    if (received) {
+        pthread_cond_signal(&bq->not_full);
+        event_rearm(bq);
+    }
+    pthread_mutex_unlock(&bq->lock);
+    return received;
+}
+
+uint32_t blocking_queue_size(blocking_queue_t* bq) {
+    if (!bq) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&bq->lock);
+    uint32_t size = queue_size(&bq->queue);
+    pthread_mutex_unlock(&bq->lock);
+    return size;
+}
+
+// Creates the eventfd on first use. Register it with epoll for EPOLLIN.
+int blocking_queue_event_fd(blocking_queue_t* bq) {
+    if (!bq) {
+        return -1;
+    }
+    
+    pthread_mutex_lock(&bq->lock);
+    if (bq->event_fd < 0) {
+        bq->event_fd = eventfd(!queue_is_empty(&bq->queue), EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+    int fd = bq->event_fd;
+    pthread_mutex_unlock(&bq->lock);
+    return fd;
+}
+
+// Non-blocking drain of up to max items for an event loop woken by the
+// eventfd. Leaves the eventfd readable if items remain, so a level-
+// triggered epoll comes back for the rest. Queue set members are refused
+// (0 items): the set expects exactly one receive per select.
+uint32_t blocking_queue_receive_batch(blocking_queue_t* bq, uint8_t* items, uint32_t max) {
+    if (!bq || !items) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&bq->lock);
+    uint32_t received = 0;
+    if (!bq->set) {
+        received = queue_dequeue_bulk(&bq->queue, items, max);
+        for (uint32_t i = 0; i < received; i++) {
+            pthread_cond_signal(&bq->not_full);
+        }
+        if (received > 0) {
+            event_rearm(bq);
+        }
+    }
+    pthread_mutex_unlock(&bq->lock);
+    return received;
+}
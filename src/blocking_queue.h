@@ -0,0 +1,41 @@
+#ifndef BLOCKING_QUEUE_H
+#define BLOCKING_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "queue.h"
+#include "timeout.h"
+
+struct queue_set;
+
+// queue_t guarded by a mutex, with condition variables that park senders
+// while the queue is full and receivers while it is empty. Each item sent
+// or received wakes at most one waiter on the other side.
+//
+// An optional eventfd lets the queue sit in an epoll set: it becomes
+// readable when the queue goes from empty to non-empty, and every receive
+// leaves it readable while items remain and clear once the queue is empty,
+// whether or not the event loop read it in between.
+typedef struct blocking_queue {
+    queue_t queue;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    struct queue_set* set;
+    int event_fd;
+} blocking_queue_t;
+
+// Function declarations
+bool blocking_queue_init(blocking_queue_t* bq, uint32_t size);
+void blocking_queue_destroy(blocking_queue_t* bq);
+bool blocking_queue_send(blocking_queue_t* bq, uint8_t item, uint32_t timeout_ms);
+bool blocking_queue_receive(blocking_queue_t* bq, uint8_t* item, uint32_t timeout_ms);
+uint32_t blocking_queue_size(blocking_queue_t* bq);
+
+// epoll integration. Batch receives return 0 on queue set members, which
+// must be drained one item per queue_set_select().
+int blocking_queue_event_fd(blocking_queue_t* bq);
+uint32_t blocking_queue_receive_batch(blocking_queue_t* bq, uint8_t* items, uint32_t max);
+
+#endif // BLOCKING_QUEUE_H
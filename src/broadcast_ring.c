@@ -0,0 +1,162 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "broadcast_ring.h"
+#include <string.h>
+#include <sched.h>
+
+#define SLOT_EMPTY UINT64_MAX
+
+static uint64_t* slot_seq(const broadcast_ring_t* ring, uint64_t seq) {
+    size_t index = (size_t)(seq & (ring->capacity - 1));
+    return (uint64_t*)(ring->storage + index * ring->slot_size);
+}
+
+static uint8_t* slot_data(const broadcast_ring_t* ring, uint64_t seq) {
+    return (uint8_t*)(slot_seq(ring, seq) + 1);
+}
+
+// Lowest cursor among active consumers; published when nobody is subscribed
+static uint64_t min_cursor(const broadcast_ring_t* ring, uint64_t published) {
+    uint64_t min = published;
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        const broadcast_consumer_t* consumer = &ring->consumers[i];
+        if (__atomic_load_n(&consumer->active, __ATOMIC_ACQUIRE)) {
+            uint64_t cursor = __atomic_load_n(&consumer->cursor, __ATOMIC_ACQUIRE);
+            if (cursor < min) {
+                min = cursor;
+            }
+        }
+    }
+    return min;
+}
+
+bool broadcast_ring_init(broadcast_ring_t* ring, uint8_t* storage, uint32_t capacity,
+                         uint32_t elem_size, bool overwrite) {
+    if (!ring || !storage || capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        elem_size == 0) {
+        return false;
+    }
+    
+    ring->storage = storage;
+    ring->capacity = capacity;
+    ring->elem_size = elem_size;
+    ring->slot_size = (uint32_t)BROADCAST_SLOT_SIZE(elem_size);
+    ring->overwrite = overwrite;
+    ring->gating_cache = 0;
+    ring->published = 0;
+    memset(ring->consumers, 0, sizeof(ring->consumers));
+    for (uint64_t seq = 0; seq < capacity; seq++) {
+        *slot_seq(ring, seq) = SLOT_EMPTY;
+    }
+    return true;
+}
+
+// Subscribers are only handed events published after they join
+int broadcast_ring_subscribe(broadcast_ring_t* ring) {
+    if (!ring) {
+        return -1;
+    }
+    
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        broadcast_consumer_t* consumer = &ring->consumers[i];
+        bool expected = false;
+        if (!__atomic_load_n(&consumer->active, __ATOMIC_ACQUIRE) &&
+            __atomic_compare_exchange_n(&consumer->active, &expected, true, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            consumer->lost = 0;
+            __atomic_store_n(&consumer->cursor,
+                             __atomic_load_n(&ring->published, __ATOMIC_ACQUIRE),
+                             __ATOMIC_RELEASE);
+            return i;
+        }
+    }
+    return -1;
+}
+
+void broadcast_ring_unsubscribe(broadcast_ring_t* ring, int consumer) {
+    if (ring && consumer >= 0 && consumer < BROADCAST_MAX_CONSUMERS) {
+        __atomic_store_n(&ring->consumers[consumer].active, false, __ATOMIC_RELEASE);
+    }
+}
+
+bool broadcast_ring_publish(broadcast_ring_t* ring, const void* event, uint32_t timeout_ms) {
+    if (!ring || !event) {
+        return false;
+    }
+    
+    uint64_t seq = ring->published;
+    if (!ring->overwrite && seq - ring->gating_cache >= ring->capacity) {
+        // Gated: wait (by yielding) until the slowest consumer frees a slot
+        struct timespec deadline, now;
+        if (timeout_ms != QUEUE_NO_WAIT && timeout_ms != QUEUE_WAIT_FOREVER) {
+            timeout_to_deadline(&deadline, timeout_ms);
+        }
+        for (;;) {
+            ring->gating_cache = min_cursor(ring, seq);
+            if (seq - ring->gating_cache < ring->capacity) {
+                break;
+            }
+            if (timeout_ms == QUEUE_NO_WAIT) {
+                return false;
+            }
+            if (timeout_ms != QUEUE_WAIT_FOREVER) {
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                if (now.tv_sec > deadline.tv_sec ||
+                    (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec)) {
+                    return false;
+                }
+            }
+            sched_yield();
+        }
+    }
+    
+    // Per-slot seqlock: readers reject a slot whose seq changes under them
+    uint64_t* slot = slot_seq(ring, seq);
+    __atomic_store_n(slot, SLOT_EMPTY, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(slot_data(ring, seq), event, ring->elem_size);
+    __atomic_store_n(slot, seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->published, seq + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool broadcast_ring_poll(broadcast_ring_t* ring, int consumer, void* event) {
+    if (!ring || !event || consumer < 0 || consumer >= BROADCAST_MAX_CONSUMERS) {
+        return false;
+    }
+    
+    broadcast_consumer_t* self = &ring->consumers[consumer];
+    uint64_t cursor = self->cursor;
+    for (;;) {
+        uint64_t published = __atomic_load_n(&ring->published, __ATOMIC_ACQUIRE);
+        if (cursor >= published) {
+            return false;
+        }
+        
+        const uint64_t* slot = slot_seq(ring, cursor);
+        if (__atomic_load_n(slot, __ATOMIC_ACQUIRE) == cursor) {
+            memcpy(event, slot_data(ring, cursor), ring->elem_size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(slot, __ATOMIC_RELAXED) == cursor) {
+                __atomic_store_n(&self->cursor, cursor + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+        
+        // The event was published and then overwritten: skip to the oldest
+        // event that can still be intact
+        published = __atomic_load_n(&ring->published, __ATOMIC_ACQUIRE);
+        uint64_t oldest = published - ring->capacity + 1;
+        if (published >= ring->capacity && oldest > cursor) {
+            self->lost += oldest - cursor;
+            cursor = oldest;
+        }
+    }
+}
+
+uint64_t broadcast_ring_lost(const broadcast_ring_t* ring, int consumer) {
+    if (!ring || consumer < 0 || consumer >= BROADCAST_MAX_CONSUMERS) {
+        return 0;
+    }
+    return ring->consumers[consumer].lost;
+}
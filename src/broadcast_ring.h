@@ -0,0 +1,48 @@
+#ifndef BROADCAST_RING_H
+#define BROADCAST_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "timeout.h"
+
+#define BROADCAST_MAX_CONSUMERS 16
+#define BROADCAST_CACHE_LINE    64
+
+// Each slot holds an 8-byte sequence number followed by the event
+#define BROADCAST_SLOT_SIZE(elem_size) (((elem_size) + 2 * sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1))
+#define BROADCAST_RING_STORAGE_SIZE(capacity, elem_size) \
+    ((size_t)(capacity) * BROADCAST_SLOT_SIZE(elem_size))
+
+typedef struct {
+    uint64_t cursor __attribute__((aligned(BROADCAST_CACHE_LINE)));
+    uint64_t lost;
+    bool active;
+} broadcast_consumer_t;
+
+// Single-writer ring where every event is written once and read by each
+// subscribed consumer through its own cursor (disruptor style). In gated
+// mode the writer never passes the slowest consumer; in overwrite mode it
+// never waits and consumers that fall a full ring behind skip ahead and
+// count the events they missed in lost.
+typedef struct {
+    uint8_t* storage;
+    uint32_t capacity;
+    uint32_t elem_size;
+    uint32_t slot_size;
+    bool overwrite;
+    uint64_t gating_cache;
+    uint64_t published __attribute__((aligned(BROADCAST_CACHE_LINE)));
+    broadcast_consumer_t consumers[BROADCAST_MAX_CONSUMERS];
+} broadcast_ring_t;
+
+// Function declarations
+bool broadcast_ring_init(broadcast_ring_t* ring, uint8_t* storage, uint32_t capacity,
+                         uint32_t elem_size, bool overwrite);
+int broadcast_ring_subscribe(broadcast_ring_t* ring);
+void broadcast_ring_unsubscribe(broadcast_ring_t* ring, int consumer);
+bool broadcast_ring_publish(broadcast_ring_t* ring, const void* event, uint32_t timeout_ms);
+bool broadcast_ring_poll(broadcast_ring_t* ring, int consumer, void* event);
+uint64_t broadcast_ring_lost(const broadcast_ring_t* ring, int consumer);
+
+#endif // BROADCAST_RING_H
@@ -0,0 +1,30 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "coroutine.h"
+#include <string.h>
+
+// Unlike green_spawn, no stack is needed: the coroutine runs on the
+// scheduler's own stack each time it is resumed
+bool co_spawn(green_sched_t* sched, co_task_t* co, uint32_t task_id, co_fn_t fn, void* arg) {
+    if (!sched || !co || !fn) {
+        return false;
+    }
+    
+    memset(co, 0, sizeof(*co));
+    co->fn = fn;
+    co->arg = arg;
+    return green_node_spawn(sched, &co->node, task_id, GREEN_KIND_COROUTINE);
+}
+
+bool co_kill(co_task_t* co) {
+    return co ? green_node_kill(&co->node) : false;
+}
+
+bool co_wake(co_task_t* co) {
+    return co ? green_node_wake(&co->node) : false;
+}
+
+// The scheduler adds the current time when it files the sleep
+void co_sleep_ns(co_task_t* co, uint64_t ns) {
+    co->node.wake_ns = ns;
+}
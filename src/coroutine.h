@@ -0,0 +1,66 @@
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "green_thread.h"
+
+// Stackless coroutine tasks in the protothread style, scheduled by the
+// green thread scheduler alongside stackful tasks: same priorities, same
+// ready lists, same sleep heap, and the same task manager state updates.
+//
+// A coroutine function is re-entered from the top on every resume and
+// CO_BEGIN jumps to the point where it last left off. Nothing is kept on a
+// stack between resumes, so local variables do not survive CO_YIELD,
+// CO_SLEEP_NS, CO_BLOCK or CO_WAIT_UNTIL: keep state in the object passed
+// as arg. The CO_ macros expand to case labels, so they cannot be used
+// inside a switch statement of the coroutine body.
+//
+// The task manager entry needs no stack (task_create with stack_size 0);
+// a coroutine then costs sizeof(co_task_t) beyond its task record.
+
+typedef enum {
+    CO_YIELDED,
+    CO_SLEEPING,
+    CO_BLOCKED,
+    CO_DONE
+} co_status_t;
+
+struct co_task;
+typedef co_status_t (*co_fn_t)(struct co_task* co, void* arg);
+
+typedef struct co_task {
+    green_node_t node;
+    co_fn_t fn;
+    void* arg;
+    uint32_t line;  // resume point, 0 before the first run
+} co_task_t;
+
+#define CO_BEGIN(co) switch ((co)->line) { case 0:
+
+#define CO_END(co) } return CO_DONE
+
+// Ready again at once, behind tasks of the same priority
+#define CO_YIELD(co) \
+    do { (co)->line = __LINE__; return CO_YIELDED; case __LINE__:; } while (0)
+
+#define CO_WAIT_UNTIL(co, cond) while (!(cond)) CO_YIELD(co)
+
+#define CO_SLEEP_NS(co, ns) \
+    do { co_sleep_ns((co), (ns)); (co)->line = __LINE__; return CO_SLEEPING; case __LINE__:; } while (0)
+
+// Parks the coroutine until co_wake()
+#define CO_BLOCK(co) \
+    do { (co)->line = __LINE__; return CO_BLOCKED; case __LINE__:; } while (0)
+
+#define CO_EXIT(co) return CO_DONE
+
+// Function declarations
+bool co_spawn(green_sched_t* sched, co_task_t* co, uint32_t task_id, co_fn_t fn, void* arg);
+bool co_kill(co_task_t* co);
+bool co_wake(co_task_t* co);
+
+// Used by CO_SLEEP_NS
+void co_sleep_ns(co_task_t* co, uint64_t ns);
+
+#endif // COROUTINE_H
@@ -0,0 +1,306 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "task.h"
+#include "task_manager.h"
+#include "timestamp.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+// Host scheduler for the FreeRTOS task API, built on the green thread
+// scheduler. vTaskStartScheduler runs every task on the calling thread, each
+// on the stack buffer given to xTaskCreateStatic, which gives the
+// single-core semantics FreeRTOS code expects: the highest-priority ready
+// task runs, equal priorities take turns in FIFO order. Switches happen
+// only inside API calls (vTaskDelay, taskYIELD, task creation and
+// deletion), so a task that never calls into the API is not preempted.
+// While the scheduler runs, the task API must be called from its tasks.
+// vTaskEndScheduler parks every task where it is; the next
+// vTaskStartScheduler resumes them rather than restarting them.
+
+// StaticTask_t must be able to hold a TCB_t
+typedef char static_tcb_size_check[(sizeof(StaticTask_t) >= sizeof(TCB_t)) ? 1 : -1];
+
+// Task ids are kept beside the TCB pointers: a TCB buffer may be wiped by
+// its owner before it is handed in again
+typedef struct {
+    TCB_t* tcb;
+    uint32_t task_id;
+} registry_entry_t;
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t tick_once = PTHREAD_ONCE_INIT;
+
+static registry_entry_t* registry = NULL;
+static uint32_t registry_count = 0;
+static uint32_t registry_capacity = 0;
+static uint32_t next_task_id = FREERTOS_TASK_ID_BASE;
+
+static green_sched_t sched;
+static bool sched_ready = false;    // sched holds parked tasks between starts
+static bool scheduler_running = false;
+static uint64_t start_ns = 0;
+
+static void tick_setup(void) {
+    start_ns = timestamp_now_ns();
+}
+
+static TCB_t* current_tcb(void) {
+    green_task_t* green = green_current();
+    if (!green || green->node.sched != &sched) {
+        return NULL;
+    }
+    return (TCB_t*)((char*)green - offsetof(TCB_t, green));
+}
+
+static int registry_find(const TCB_t* tcb) {
+    for (uint32_t i = 0; i < registry_count; i++) {
+        if (registry[i].tcb == tcb) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static bool registry_add(TCB_t* tcb) {
+    if (registry_count == registry_capacity) {
+        uint32_t capacity = registry_capacity ? 2 * registry_capacity : MAX_TASKS;
+        registry_entry_t* grown = realloc(registry, capacity * sizeof(*grown));
+        if (!grown) {
+            return false;
+        }
+        registry = grown;
+        registry_capacity = capacity;
+    }
+    registry[registry_count].tcb = tcb;
+    registry[registry_count].task_id = tcb->task_id;
+    registry_count++;
+    return true;
+}
+
+// Removes tcb, keeping creation order for the next scheduler start.
+// Returns the task id it was registered under, or 0 if it was not.
+static uint32_t registry_remove(const TCB_t* tcb) {
+    pthread_mutex_lock(&registry_lock);
+    int index = registry_find(tcb);
+    uint32_t task_id = 0;
+    if (index >= 0) {
+        task_id = registry[index].task_id;
+        for (uint32_t i = (uint32_t)index; i + 1 < registry_count; i++) {
+            registry[i] = registry[i + 1];
+        }
+        registry_count--;
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return task_id;
+}
+
+static void task_entry(void* arg) {
+    TCB_t* tcb = arg;
+    tcb->task_code(tcb->parameters);
+    // FreeRTOS tasks must not return; treat it as deleting itself
+    vTaskDelete(NULL);
+}
+
+static bool spawn(TCB_t* tcb) {
+    tcb->spawned = green_spawn(&sched, &tcb->green, tcb->task_id, task_entry, tcb);
+    return tcb->spawned;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char* pcName,
+                               uint32_t ulStackDepth, void* pvParameters,
+                               UBaseType_t uxPriority, StackType_t* puxStackBuffer,
+                               StaticTask_t* pxTaskBuffer) {
+    if (!pxTaskCode || !puxStackBuffer || !pxTaskBuffer ||
+        (uint64_t)ulStackDepth * sizeof(StackType_t) < GREEN_MIN_STACK) {
+        return NULL;
+    }
+    pthread_once(&tick_once, tick_setup);
+    
+    // A TCB buffer handed in again means its previous task is gone
+    TCB_t* tcb = (TCB_t*)pxTaskBuffer;
+    if (tcb == current_tcb()) {
+        return NULL;
+    }
+    vTaskDelete(tcb);
+    
+    if (uxPriority >= configMAX_PRIORITIES) {
+        uxPriority = configMAX_PRIORITIES - 1;
+    }
+    
+    memset(tcb, 0, sizeof(*tcb));
+    tcb->pxStack = puxStackBuffer;
+    tcb->pxTopOfStack = puxStackBuffer + ulStackDepth - 1;
+    if (pcName) {
+        strncpy(tcb->pcTaskName, pcName, configMAX_TASK_NAME_LEN - 1);
+    }
+    tcb->uxPriority = uxPriority;
+    tcb->uxBasePriority = uxPriority;
+    tcb->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
+    tcb->stack_depth = ulStackDepth;
+    tcb->task_code = pxTaskCode;
+    tcb->parameters = pvParameters;
+    
+    pthread_mutex_lock(&registry_lock);
+    tcb->task_id = next_task_id++;
+    if (!task_create_static(tcb->task_id, tcb->pcTaskName, (uint32_t)uxPriority,
+                            puxStackBuffer, ulStackDepth * sizeof(StackType_t))) {
+        pthread_mutex_unlock(&registry_lock);
+        return NULL;
+    }
+    if (!registry_add(tcb)) {
+        task_delete(tcb->task_id);
+        pthread_mutex_unlock(&registry_lock);
+        return NULL;
+    }
+    pthread_mutex_unlock(&registry_lock);
+    
+    // Created while the scheduler runs: ready at once, and preempts a
+    // lower-priority creator
+    if (scheduler_running) {
+        if (!spawn(tcb)) {
+            vTaskDelete(tcb);
+            return NULL;
+        }
+        TCB_t* self = current_tcb();
+        if (self && uxPriority > self->uxPriority) {
+            green_yield();
+        }
+    }
+    return tcb;
+}
+
+void vTaskDelete(TaskHandle_t xTask) {
+    TCB_t* self = current_tcb();
+    TCB_t* tcb = xTask ? xTask : self;
+    if (!tcb) {
+        return;
+    }
+    uint32_t task_id = registry_remove(tcb);
+    if (task_id == 0) {
+        return;
+    }
+    
+    if (tcb == self) {
+        // The green scheduler deletes the task entry once off its stack
+        green_exit();
+    } else if (tcb->spawned) {
+        green_kill(&tcb->green);
+    } else {
+        task_delete(task_id);
+    }
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask) {
+    TCB_t* tcb = xTask ? xTask : current_tcb();
+    return tcb ? tcb->uxPriority : tskIDLE_PRIORITY;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void) {
+    pthread_mutex_lock(&registry_lock);
+    UBaseType_t count = registry_count;
+    pthread_mutex_unlock(&registry_lock);
+    return count;
+}
+
+// Least free stack space the task has had, in words. The stack buffer was
+// painted by the task manager when the task was created.
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+    TCB_t* tcb = xTask ? xTask : current_tcb();
+    if (!tcb) {
+        return 0;
+    }
+    return task_get_stack_high_water_mark(tcb->task_id) / sizeof(StackType_t);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return current_tcb();
+}
+
+char* pcTaskGetName(TaskHandle_t xTask) {
+    TCB_t* tcb = xTask ? xTask : current_tcb();
+    return tcb ? tcb->pcTaskName : NULL;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    pthread_once(&tick_once, tick_setup);
+    uint64_t elapsed = timestamp_now_ns() - start_ns;
+    return (TickType_t)((elapsed * configTICK_RATE_HZ) / 1000000000u);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay) {
+    uint64_t ns = ((uint64_t)xTicksToDelay * 1000000000u) / configTICK_RATE_HZ;
+    if (current_tcb()) {
+        green_sleep_ns(ns);
+        return;
+    }
+    
+    // Not a scheduled task: block the calling thread only
+    struct timespec ts = { (time_t)(ns / 1000000000u), (long)(ns % 1000000000u) };
+    nanosleep(&ts, NULL);
+}
+
+void vPortYield(void) {
+    green_yield();
+}
+
+// Task manager state of a task parked in the scheduler
+static task_state_t parked_state(const TCB_t* tcb) {
+    return tcb->green.node.state == GREEN_READY ? TASK_READY : TASK_BLOCKED;
+}
+
+// Runs the tasks on the calling thread. Returns once vTaskEndScheduler is
+// called or every task has been deleted. Tasks parked by an earlier
+// vTaskEndScheduler carry on from where they stopped. Like FreeRTOS when it
+// cannot create its idle task, returns at once if a task cannot be
+// spawned; tasks spawned by then start with the next call.
+void vTaskStartScheduler(void) {
+    if (scheduler_running) {
+        return;
+    }
+    pthread_once(&tick_once, tick_setup);
+    if (!sched_ready) {
+        if (!green_sched_init(&sched)) {
+            return;
+        }
+        sched_ready = true;
+    }
+    
+    bool spawned = true;
+    pthread_mutex_lock(&registry_lock);
+    for (uint32_t i = 0; i < registry_count && spawned; i++) {
+        TCB_t* tcb = registry[i].tcb;
+        if (tcb->spawned) {
+            task_set_state(registry[i].task_id, parked_state(tcb));
+        } else {
+            spawned = spawn(tcb);
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
+    if (!spawned) {
+        return;
+    }
+    
+    scheduler_running = true;
+    green_sched_run(&sched);
+    scheduler_running = false;
+    
+    // Tasks still registered are parked and show as suspended until the
+    // next start
+    pthread_mutex_lock(&registry_lock);
+    for (uint32_t i = 0; i < registry_count; i++) {
+        task_set_state(registry[i].task_id, TASK_SUSPENDED);
+    }
+    pthread_mutex_unlock(&registry_lock);
+    if (sched.live == 0) {
+        green_sched_destroy(&sched);
+        sched_ready = false;
+    }
+}
+
+// Makes vTaskStartScheduler return. Called from a task, it does not return.
+void vTaskEndScheduler(void) {
+    green_sched_stop();
+}
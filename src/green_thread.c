@@ -0,0 +1,466 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "green_thread.h"
+#include "coroutine.h"
+#include "task_manager.h"
+#include "timestamp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SLEEP_INITIAL_CAPACITY 16
+
+static __thread green_sched_t* current_sched = NULL;
+
+#if GREEN_ASM_SWITCH
+// void green_context_switch(void** save_sp, void* load_sp)
+// Pushes the callee-saved registers, stores the stack pointer, switches to
+// the other stack and pops its registers. Everything else is caller-saved
+// under the SysV ABI, so the compiler has already spilled it.
+void green_context_switch(void** save_sp, void* load_sp);
+__asm__(
+    ".text\n"
+    ".globl green_context_switch\n"
+    ".type green_context_switch, @function\n"
+    "green_context_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size green_context_switch, .-green_context_switch\n"
+);
+#endif
+
+static void context_switch(green_context_t* from, green_context_t* to) {
+#if GREEN_ASM_SWITCH
+    green_context_switch(&from->sp, to->sp);
+#else
+    swapcontext(&from->uc, &to->uc);
+#endif
+}
+
+// First frame of every task; never returns
+static void green_trampoline(void) {
+    green_task_t* task = (green_task_t*)current_sched->current;
+    task->entry(task->arg);
+    green_exit();
+}
+
+static void context_init(green_context_t* context, void* stack, uint32_t stack_size) {
+#if GREEN_ASM_SWITCH
+    // Initial frame popped by green_context_switch: six zeroed registers,
+    // then the trampoline as return address. The slot above it stands in
+    // for the trampoline's own return address, keeping the ABI alignment
+    // (rsp + 8 a multiple of 16 at function entry).
+    uintptr_t top = ((uintptr_t)stack + stack_size) & ~(uintptr_t)15;
+    void** sp = (void**)top;
+    *--sp = NULL;
+    *--sp = (void*)green_trampoline;
+    for (int i = 0; i < 6; i++) {
+        *--sp = NULL;
+    }
+    context->sp = sp;
+#else
+    getcontext(&context->uc);
+    context->uc.uc_stack.ss_sp = stack;
+    context->uc.uc_stack.ss_size = stack_size;
+    context->uc.uc_link = NULL;
+    makecontext(&context->uc, green_trampoline, 0);
+#endif
+}
+
+static void ready_push(green_sched_t* sched, green_node_t* node) {
+    uint32_t prio = node->priority;
+    node->state = GREEN_READY;
+    node->next = NULL;
+    node->prev = sched->ready_tail[prio];
+    if (node->prev) {
+        node->prev->next = node;
+    } else {
+        sched->ready_head[prio] = node;
+        sched->ready_bitmap |= 1u << prio;
+    }
+    sched->ready_tail[prio] = node;
+}
+
+static void ready_remove(green_sched_t* sched, green_node_t* node) {
+    uint32_t prio = node->priority;
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        sched->ready_head[prio] = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        sched->ready_tail[prio] = node->prev;
+    }
+    if (!sched->ready_head[prio]) {
+        sched->ready_bitmap &= ~(1u << prio);
+    }
+}
+
+static green_node_t* ready_pop(green_sched_t* sched) {
+    uint32_t prio = 31u - (uint32_t)__builtin_clz(sched->ready_bitmap);
+    green_node_t* node = sched->ready_head[prio];
+    ready_remove(sched, node);
+    return node;
+}
+
+// Sleeping tasks are kept in a binary min-heap on wake time
+static void sleep_swap(green_sched_t* sched, uint32_t a, uint32_t b) {
+    green_node_t* tmp = sched->sleepers[a];
+    sched->sleepers[a] = sched->sleepers[b];
+    sched->sleepers[b] = tmp;
+    sched->sleepers[a]->sleep_index = a;
+    sched->sleepers[b]->sleep_index = b;
+}
+
+static void sleep_sift_up(green_sched_t* sched, uint32_t i) {
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (sched->sleepers[parent]->wake_ns <= sched->sleepers[i]->wake_ns) {
+            return;
+        }
+        sleep_swap(sched, i, parent);
+        i = parent;
+    }
+}
+
+static void sleep_sift_down(green_sched_t* sched, uint32_t i) {
+    for (;;) {
+        uint32_t smallest = i;
+        uint32_t left = 2 * i + 1;
+        uint32_t right = left + 1;
+        if (left < sched->sleeper_count &&
+            sched->sleepers[left]->wake_ns < sched->sleepers[smallest]->wake_ns) {
+            smallest = left;
+        }
+        if (right < sched->sleeper_count &&
+            sched->sleepers[right]->wake_ns < sched->sleepers[smallest]->wake_ns) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        sleep_swap(sched, i, smallest);
+        i = smallest;
+    }
+}
+
+static bool sleep_push(green_sched_t* sched, green_node_t* node) {
+    if (sched->sleeper_count == sched->sleeper_capacity) {
+        uint32_t capacity = sched->sleeper_capacity ? 2 * sched->sleeper_capacity
+                                                    : SLEEP_INITIAL_CAPACITY;
+        green_node_t** sleepers = realloc(sched->sleepers, capacity * sizeof(*sleepers));
+        if (!sleepers) {
+            return false;
+        }
+        sched->sleepers = sleepers;
+        sched->sleeper_capacity = capacity;
+    }
+    node->state = GREEN_SLEEPING;
+    node->sleep_index = sched->sleeper_count;
+    sched->sleepers[sched->sleeper_count++] = node;
+    sleep_sift_up(sched, node->sleep_index);
+    return true;
+}
+
+static void sleep_remove(green_sched_t* sched, green_node_t* node) {
+    uint32_t i = node->sleep_index;
+    uint32_t last = --sched->sleeper_count;
+    if (i != last) {
+        sleep_swap(sched, i, last);
+        sleep_sift_down(sched, i);
+        sleep_sift_up(sched, i);
+    }
+}
+
+static void wake_sleepers(green_sched_t* sched, uint64_t now) {
+    while (sched->sleeper_count > 0 && sched->sleepers[0]->wake_ns <= now) {
+        green_node_t* node = sched->sleepers[0];
+        sleep_remove(sched, node);
+        task_set_state(node->task_id, TASK_READY);
+        ready_push(sched, node);
+    }
+}
+
+static void idle_until(uint64_t wake_ns) {
+    struct timespec ts = {
+        (time_t)(wake_ns / 1000000000u), (long)(wake_ns % 1000000000u)
+    };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+// Returns control from the current task to the scheduler loop
+static void switch_to_sched(green_task_t* task) {
+    context_switch(&task->context, &task->node.sched->context);
+}
+
+// Files a task that has just given the CPU back under the state it asked
+// for. Runs on the scheduler stack, so a task's own stack only ever holds
+// its call into this file and the context switch, never the sleep heap
+// growth or the task manager update.
+static void node_park(green_sched_t* sched, green_node_t* node) {
+    if (node->state == GREEN_READY) {
+        task_set_state(node->task_id, TASK_READY);
+        ready_push(sched, node);
+    } else if (node->state == GREEN_SLEEPING) {
+        // wake_ns holds the requested delay until now
+        node->wake_ns += timestamp_now_ns();
+        if (sleep_push(sched, node)) {
+            task_set_state(node->task_id, TASK_BLOCKED);
+        } else {
+            task_set_state(node->task_id, TASK_READY);
+            ready_push(sched, node);
+        }
+    } else if (node->state == GREEN_BLOCKED) {
+        task_set_state(node->task_id, TASK_BLOCKED);
+    }
+}
+
+// Runs a coroutine up to its next CO_ macro and files it by the result
+static void co_run(green_sched_t* sched, co_task_t* co) {
+    co_status_t status = co->fn(co, co->arg);
+    if (status == CO_YIELDED) {
+        co->node.state = GREEN_READY;
+    } else if (status == CO_SLEEPING) {
+        co->node.state = GREEN_SLEEPING;
+    } else if (status == CO_BLOCKED) {
+        co->node.state = GREEN_BLOCKED;
+    } else {
+        co->node.state = GREEN_DONE;
+    }
+    node_park(sched, &co->node);
+}
+
+// Runs a stackful task until it switches back, then checks that it stayed
+// within its stack before filing it
+static void thread_run(green_sched_t* sched, green_task_t* task) {
+    context_switch(&sched->context, &task->context);
+    if (!stack_canary_intact(task->stack)) {
+        fprintf(stderr, "green thread: task %u overflowed its stack\n", task->node.task_id);
+        abort();
+    }
+    node_park(sched, &task->node);
+}
+
+bool green_sched_init(green_sched_t* sched) {
+    if (!sched) {
+        return false;
+    }
+    memset(sched, 0, sizeof(*sched));
+    return true;
+}
+
+void green_sched_destroy(green_sched_t* sched) {
+    if (sched) {
+        free(sched->sleepers);
+        sched->sleepers = NULL;
+        sched->sleeper_capacity = 0;
+        sched->sleeper_count = 0;
+    }
+}
+
+// Runs tasks until none is ready or sleeping, or green_sched_stop() is
+// called. Tasks still blocked at that point stay blocked.
+void green_sched_run(green_sched_t* sched) {
+    if (!sched) {
+        return;
+    }
+    green_sched_t* outer = current_sched;
+    current_sched = sched;
+    sched->stop = false;
+    
+    while (!sched->stop) {
+        if (sched->sleeper_count > 0) {
+            wake_sleepers(sched, timestamp_now_ns());
+        }
+        if (!sched->ready_bitmap) {
+            if (sched->sleeper_count == 0) {
+                break;
+            }
+            idle_until(sched->sleepers[0]->wake_ns);
+            continue;
+        }
+    
+        green_node_t* node = ready_pop(sched);
+        node->state = GREEN_RUNNING;
+        sched->current = node;
+        task_set_current(node->task_id);
+        task_set_state(node->task_id, TASK_RUNNING);
+        if (node->kind == GREEN_KIND_COROUTINE) {
+            co_run(sched, (co_task_t*)node);
+        } else {
+            thread_run(sched, (green_task_t*)node);
+        }
+        sched->current = NULL;
+    
+        // The stack can only be released once nothing runs on it
+        if (node->state == GREEN_DONE) {
+            sched->live--;
+            task_delete(node->task_id);
+        }
+    }
+    
+    task_clear_current();
+    current_sched = outer;
+}
+
+// Makes green_sched_run() return. Called from a task, the task stays ready
+// and resumes on the next green_sched_run().
+void green_sched_stop(void) {
+    if (current_sched) {
+        current_sched->stop = true;
+        green_yield();
+    }
+}
+
+bool green_node_spawn(green_sched_t* sched, green_node_t* node, uint32_t task_id,
+                      green_kind_t kind) {
+    if (!sched || !node) {
+        return false;
+    }
+    task_t* record = task_get(task_id);
+    if (!record) {
+        return false;
+    }
+    
+    node->sched = sched;
+    node->task_id = task_id;
+    node->kind = (uint8_t)kind;
+    node->priority = (uint8_t)(record->priority < GREEN_PRIORITIES ? record->priority
+                                                                    : GREEN_PRIORITIES - 1);
+    sched->live++;
+    ready_push(sched, node);
+    return true;
+}
+
+bool green_spawn(green_sched_t* sched, green_task_t* task, uint32_t task_id,
+                 green_entry_t entry, void* arg) {
+    if (!sched || !task || !entry) {
+        return false;
+    }
+    task_t* record = task_get(task_id);
+    if (!record || !record->stack || record->stack_size < GREEN_MIN_STACK) {
+        return false;
+    }
+    
+    memset(task, 0, sizeof(*task));
+    task->entry = entry;
+    task->arg = arg;
+    task->stack = record->stack;
+    context_init(&task->context, record->stack, record->stack_size);
+    return green_node_spawn(sched, &task->node, task_id, GREEN_KIND_THREAD);
+}
+
+// Removes a task that is not running and deletes its task manager entry.
+// A running coroutine cannot be killed; it ends itself with CO_EXIT.
+bool green_node_kill(green_node_t* node) {
+    if (!node || node->state == GREEN_DONE) {
+        return false;
+    }
+    green_sched_t* sched = node->sched;
+    if (node == sched->current) {
+        if (node->kind == GREEN_KIND_COROUTINE) {
+            return false;
+        }
+        green_exit();
+    }
+    
+    if (node->state == GREEN_READY) {
+        ready_remove(sched, node);
+    } else if (node->state == GREEN_SLEEPING) {
+        sleep_remove(sched, node);
+    }
+    node->state = GREEN_DONE;
+    sched->live--;
+    task_delete(node->task_id);
+    return true;
+}
+
+bool green_kill(green_task_t* task) {
+    return task ? green_node_kill(&task->node) : false;
+}
+
+// Stackful task currently running, NULL inside a coroutine or outside the
+// scheduler
+green_task_t* green_current(void) {
+    if (!current_sched || !current_sched->current ||
+        current_sched->current->kind != GREEN_KIND_THREAD) {
+        return NULL;
+    }
+    return (green_task_t*)current_sched->current;
+}
+
+// The calls below only record what the task asks for and switch away;
+// node_park does the rest on the scheduler stack
+void green_yield(void) {
+    green_task_t* task = green_current();
+    if (!task) {
+        return;
+    }
+    task->node.state = GREEN_READY;
+    switch_to_sched(task);
+}
+
+void green_sleep_ns(uint64_t ns) {
+    green_task_t* task = green_current();
+    if (!task) {
+        return;
+    }
+    task->node.wake_ns = ns;
+    task->node.state = ns ? GREEN_SLEEPING : GREEN_READY;
+    switch_to_sched(task);
+}
+
+// Parks the current task until green_wake()
+void green_block(void) {
+    green_task_t* task = green_current();
+    if (!task) {
+        return;
+    }
+    task->node.state = GREEN_BLOCKED;
+    switch_to_sched(task);
+}
+
+void green_exit(void) {
+    green_task_t* task = green_current();
+    if (!task) {
+        return;
+    }
+    task->node.state = GREEN_DONE;
+    switch_to_sched(task);
+    __builtin_unreachable();
+}
+
+// Makes a blocked or sleeping task ready again
+bool green_node_wake(green_node_t* node) {
+    if (!node) {
+        return false;
+    }
+    if (node->state == GREEN_SLEEPING) {
+        sleep_remove(node->sched, node);
+    } else if (node->state != GREEN_BLOCKED) {
+        return false;
+    }
+    task_set_state(node->task_id, TASK_READY);
+    ready_push(node->sched, node);
+    return true;
+}
+
+bool green_wake(green_task_t* task) {
+    return task ? green_node_wake(&task->node) : false;
+}
@@ -0,0 +1,120 @@
+#ifndef GREEN_THREAD_H
+#define GREEN_THREAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stack_profile.h"
+
+// Context switching uses a few lines of assembly on x86-64 (callee-saved
+// registers and the stack pointer only) and falls back to ucontext
+// elsewhere, or when built with -DGREEN_USE_UCONTEXT
+#if defined(__x86_64__) && !defined(GREEN_USE_UCONTEXT)
+#define GREEN_ASM_SWITCH 1
+#else
+#define GREEN_ASM_SWITCH 0
+#include <ucontext.h>
+#endif
+
+#define GREEN_PRIORITIES 32
+#define GREEN_MIN_STACK  STACK_MIN_SIZE
+
+typedef void (*green_entry_t)(void* arg);
+
+typedef enum {
+    GREEN_READY,
+    GREEN_RUNNING,
+    GREEN_SLEEPING,
+    GREEN_BLOCKED,
+    GREEN_DONE
+} green_state_t;
+
+typedef enum {
+    GREEN_KIND_THREAD,      // stackful, see green_spawn
+    GREEN_KIND_COROUTINE    // stackless, see coroutine.h
+} green_kind_t;
+
+struct green_sched;
+
+// Scheduling state shared by both task kinds: ready list links, sleep heap
+// position and wake time. A task leaving the CPU sets state to what it asks
+// for (and wake_ns to the delay, for a sleep); the scheduler then files it.
+typedef struct green_node {
+    struct green_sched* sched;
+    struct green_node* prev;
+    struct green_node* next;
+    uint64_t wake_ns;
+    uint32_t sleep_index;
+    uint32_t task_id;
+    uint8_t priority;
+    uint8_t state;
+    uint8_t kind;
+} green_node_t;
+
+// Saved execution state of a task or of the scheduler loop
+typedef struct {
+#if GREEN_ASM_SWITCH
+    void* sp;
+#else
+    ucontext_t uc;
+#endif
+} green_context_t;
+
+typedef struct green_task {
+    green_node_t node;
+    green_context_t context;
+    green_entry_t entry;
+    void* arg;
+    void* stack;            // low end, checked for overflow on every switch
+} green_task_t;
+
+// User-space scheduler running green tasks on the OS thread that calls
+// green_sched_run(). Each task runs on the stack recorded in its task
+// manager entry: a pool stack of stack_size bytes from task_create(), or
+// the caller's buffer from task_create_static(). The highest-priority
+// ready task runs (ready lists per priority plus a bitmap, so picking is
+// O(1)); tasks of equal priority take turns in FIFO order. Switching is
+// cooperative: a task runs until it yields, sleeps, blocks or returns.
+// Stackless coroutines (coroutine.h) share the ready lists and sleep heap
+// and are resumed directly on the scheduler's own stack. A stack must hold
+// at least GREEN_MIN_STACK bytes; overflowing it aborts at the next switch.
+// A scheduler and its tasks belong to one OS thread; green_wake() must be
+// called from that thread.
+typedef struct green_sched {
+    green_context_t context;
+    green_node_t* ready_head[GREEN_PRIORITIES];
+    green_node_t* ready_tail[GREEN_PRIORITIES];
+    uint32_t ready_bitmap;
+    green_node_t** sleepers;
+    uint32_t sleeper_count;
+    uint32_t sleeper_capacity;
+    green_node_t* current;
+    uint32_t live;
+    bool stop;
+} green_sched_t;
+
+// Function declarations
+bool green_sched_init(green_sched_t* sched);
+void green_sched_destroy(green_sched_t* sched);
+void green_sched_run(green_sched_t* sched);
+void green_sched_stop(void);
+
+bool green_spawn(green_sched_t* sched, green_task_t* task, uint32_t task_id,
+                 green_entry_t entry, void* arg);
+bool green_kill(green_task_t* task);
+green_task_t* green_current(void);
+
+// Only valid inside a green task
+void green_yield(void);
+void green_sleep_ns(uint64_t ns);
+void green_block(void);
+void green_exit(void);
+
+bool green_wake(green_task_t* task);
+
+// Kind-independent operations, used by the coroutine API
+bool green_node_spawn(green_sched_t* sched, green_node_t* node, uint32_t task_id,
+                      green_kind_t kind);
+bool green_node_kill(green_node_t* node);
+bool green_node_wake(green_node_t* node);
+
+#endif // GREEN_THREAD_H
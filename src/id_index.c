@@ -0,0 +1,44 @@
+#include "id_index.h"
+
+void id_index_clear(id_index_t* index) {
+    for (uint32_t i = 0; i <= index->mask; i++) {
+        index->slots[i] = ID_INDEX_FREE;
+    }
+}
+
+// Returns the position holding id, or the free position where it would be
+// inserted. ID_INDEX_NONE if a full sweep finds neither, which keeping the
+// index at most half full rules out.
+uint32_t id_index_probe(const id_index_t* index, uint32_t id) {
+    uint32_t pos = id_index_hash(index, id);
+    for (uint32_t step = 0; step <= index->mask; step++) {
+        if (index->slots[pos] == ID_INDEX_FREE || index->keys[pos] == id) {
+            return pos;
+        }
+        pos = (pos + 1) & index->mask;
+    }
+    return ID_INDEX_NONE;
+}
+
+// Removes the entry at pos, shifting later entries of the probe chain back
+// so lookups never need tombstones
+void id_index_remove(id_index_t* index, uint32_t pos) {
+    uint32_t next = pos;
+    index->slots[pos] = ID_INDEX_FREE;
+    for (;;) {
+        next = (next + 1) & index->mask;
+        if (index->slots[next] == ID_INDEX_FREE) {
+            return;
+        }
+        uint32_t home = id_index_hash(index, index->keys[next]);
+        // Move the entry back unless its home lies cyclically in (pos, next]
+        bool stays = (pos <= next) ? (pos < home && home <= next)
+                                   : (pos < home || home <= next);
+        if (!stays) {
+            index->keys[pos] = index->keys[next];
+            index->slots[pos] = index->slots[next];
+            index->slots[next] = ID_INDEX_FREE;
+            pos = next;
+        }
+    }
+}
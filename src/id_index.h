@@ -0,0 +1,29 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ID_INDEX_FREE UINT32_MAX   // slot value of an empty position
+#define ID_INDEX_NONE UINT32_MAX   // probe result when the index is full
+
+// Open-addressed id -> slot map with linear probing, shared by the task
+// table and the mailbox table. The caller owns the arrays, sized to a power
+// of two (mask + 1 entries) and kept at most half full, and provides the
+// locking. Slot values other than ID_INDEX_FREE are the caller's own.
+typedef struct {
+    uint32_t* keys;
+    uint32_t* slots;
+    uint32_t mask;
+} id_index_t;
+
+static inline uint32_t id_index_hash(const id_index_t* index, uint32_t id) {
+    return (id * 0x9E3779B1u) & index->mask;
+}
+
+// Function declarations
+void id_index_clear(id_index_t* index);
+uint32_t id_index_probe(const id_index_t* index, uint32_t id);
+void id_index_remove(id_index_t* index, uint32_t pos);
+
+#endif // ID_INDEX_H
@@ -0,0 +1,143 @@
+#define _GNU_SOURCE
+
+#include "isr_queue.h"
+#include "task_manager.h"
+#include <errno.h>
+
+bool isr_queue_init(isr_queue_t* q, uint32_t handler_priority) {
+    if (!q || sem_init(&q->wakeup, 0, 0) != 0) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < ISR_QUEUE_SIZE; i++) {
+        q->slots[i].seq = i;
+        q->slots[i].item = 0;
+    }
+    q->enqueue_pos = 0;
+    q->dequeue_pos = 0;
+    q->pending = 0;
+    q->overflows = 0;
+    q->handler_priority = handler_priority;
+    return true;
+}
+
+void isr_queue_destroy(isr_queue_t* q) {
+    if (q) {
+        sem_destroy(&q->wakeup);
+    }
+}
+
+// Async-signal-safe. Sets *higher_priority_task_woken when this send woke
+// the deferred handler and its task outranks the interrupted task, the
+// same contract as pxHigherPriorityTaskWoken.
+bool isr_queue_send_from_isr(isr_queue_t* q, uint8_t item, bool* higher_priority_task_woken) {
+    if (!q) {
+        return false;
+    }
+    
+    uint32_t pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+    isr_slot_t* slot;
+    for (;;) {
+        slot = &q->slots[pos & (ISR_QUEUE_SIZE - 1)];
+        uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&q->enqueue_pos, &pos, pos + 1, false,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&q->overflows, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            pos = __atomic_load_n(&q->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    slot->item = item;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    
+    // Only the first send after the handler went to sleep posts
+    bool woke = __atomic_exchange_n(&q->pending, 1, __ATOMIC_ACQ_REL) == 0;
+    if (woke) {
+        sem_post(&q->wakeup);
+    }
+    if (higher_priority_task_woken && woke &&
+        q->handler_priority > task_get_current_priority()) {
+        *higher_priority_task_woken = true;
+    }
+    return true;
+}
+
+// Single consumer: only the deferred handler thread may call this
+bool isr_queue_receive(isr_queue_t* q, uint8_t* item) {
+    if (!q || !item) {
+        return false;
+    }
+    
+    uint32_t pos = q->dequeue_pos;
+    isr_slot_t* slot = &q->slots[pos & (ISR_QUEUE_SIZE - 1)];
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+        return false;
+    }
+    
+    *item = slot->item;
+    q->dequeue_pos = pos + 1;
+    __atomic_store_n(&slot->seq, pos + ISR_QUEUE_SIZE, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Deferred handler: waits up to timeout_ms for a send, then calls handler
+// for every queued item. Returns the number of items handled. The calling
+// task, if any, is shown as TASK_BLOCKED only if it actually has to wait.
+uint32_t isr_queue_process(isr_queue_t* q, isr_handler_t handler, void* arg,
+                           uint32_t timeout_ms) {
+    if (!q || !handler) {
+        return 0;
+    }
+    
+    // A wakeup already posted is taken without blocking
+    int rc;
+    do {
+        rc = sem_trywait(&q->wakeup);
+    } while (rc != 0 && errno == EINTR);
+    
+    if (rc != 0 && timeout_ms != QUEUE_NO_WAIT) {
+        uint32_t task_id;
+        bool has_task = task_get_current(&task_id);
+        if (has_task) {
+            task_set_state(task_id, TASK_BLOCKED);
+        }
+    
+        struct timespec deadline;
+        if (timeout_ms != QUEUE_WAIT_FOREVER) {
+            timeout_to_deadline(&deadline, timeout_ms);
+        }
+        do {
+            if (timeout_ms == QUEUE_WAIT_FOREVER) {
+                rc = sem_wait(&q->wakeup);
+            } else {
+                rc = sem_clockwait(&q->wakeup, CLOCK_MONOTONIC, &deadline);
+            }
+        } while (rc != 0 && errno == EINTR);
+    
+        if (has_task) {
+            task_set_state(task_id, TASK_RUNNING);
+        }
+    }
+    
+    // Re-arm before draining so a send racing with the drain posts again
+    __atomic_store_n(&q->pending, 0, __ATOMIC_SEQ_CST);
+    
+    uint32_t handled = 0;
+    uint8_t item;
+    while (isr_queue_receive(q, &item)) {
+        handler(item, arg);
+        handled++;
+    }
+    return handled;
+}
+
+uint32_t isr_queue_overflows(const isr_queue_t* q) {
+    return q ? __atomic_load_n(&q->overflows, __ATOMIC_RELAXED) : 0;
+}
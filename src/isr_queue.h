@@ -0,0 +1,45 @@
+#ifndef ISR_QUEUE_H
+#define ISR_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include "timeout.h"
+
+#define ISR_QUEUE_SIZE       64  // power of two
+#define ISR_QUEUE_CACHE_LINE 64
+
+typedef struct {
+    uint32_t seq;
+    uint8_t item;
+} isr_slot_t;
+
+typedef void (*isr_handler_t)(uint8_t item, void* arg);
+
+// Queue that can be written from a signal handler or timer callback, the
+// host analog of the FreeRTOS ...FromISR APIs. isr_queue_send_from_isr()
+// takes no locks and makes no calls that are not async-signal-safe: slots
+// are claimed with a CAS on a per-slot sequence number (bounded MPMC ring)
+// and the deferred handler thread is woken with sem_post(). With a single
+// interrupt source the CAS never retries, so the send is wait-free.
+// Items are drained on a normal thread by isr_queue_process().
+typedef struct {
+    isr_slot_t slots[ISR_QUEUE_SIZE];
+    uint32_t enqueue_pos __attribute__((aligned(ISR_QUEUE_CACHE_LINE)));
+    uint32_t dequeue_pos __attribute__((aligned(ISR_QUEUE_CACHE_LINE)));
+    uint32_t pending;
+    uint32_t overflows;
+    uint32_t handler_priority;
+    sem_t wakeup;
+} isr_queue_t;
+
+// Function declarations
+bool isr_queue_init(isr_queue_t* q, uint32_t handler_priority);
+void isr_queue_destroy(isr_queue_t* q);
+bool isr_queue_send_from_isr(isr_queue_t* q, uint8_t item, bool* higher_priority_task_woken);
+bool isr_queue_receive(isr_queue_t* q, uint8_t* item);
+uint32_t isr_queue_process(isr_queue_t* q, isr_handler_t handler, void* arg,
+                           uint32_t timeout_ms);
+uint32_t isr_queue_overflows(const isr_queue_t* q);
+
+#endif // ISR_QUEUE_H
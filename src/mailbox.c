@@ -0,0 +1,387 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "mailbox.h"
+#include "id_index.h"
+#include "timestamp.h"
+#include <stdlib.h>
+
+#define SLOT_PENDING (ID_INDEX_FREE - 1)   // a receiver waits for the first send
+
+// The first MAILBOX_POOL_SIZE mailboxes live in static storage; further
+// ones are allocated in chunks by the sends that need them, so a large
+// task capacity costs nothing until tasks actually get messages
+static mailbox_t default_pool[MAILBOX_POOL_SIZE];
+static uint32_t default_table_keys[MAILBOX_TABLE_SIZE];
+static uint32_t default_table_slots[MAILBOX_TABLE_SIZE];
+static bool default_pool_ready = false;
+
+static mailbox_t** chunks = NULL;   // heap chunks of MAILBOX_CHUNK_SIZE
+static uint32_t chunk_count = 0;
+static uint32_t pool_size = MAILBOX_POOL_SIZE;    // mailboxes made so far
+static uint32_t pool_limit = MAILBOX_POOL_SIZE;   // the task capacity
+static mailbox_t* free_list = NULL;
+
+// task_id -> pool slot, or SLOT_PENDING
+static id_index_t table = { default_table_keys, default_table_slots, MAILBOX_TABLE_SIZE - 1 };
+static uint32_t table_used = 0;
+static pthread_mutex_t table_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t created;
+static bool initialized = false;
+
+static bool has_space(const void* ctx) {
+    const mailbox_t* mailbox = ctx;
+    return mailbox->closed || !queue_is_full(&mailbox->queue.queue);
+}
+
+static bool has_items(const void* ctx) {
+    const mailbox_t* mailbox = ctx;
+    return mailbox->closed || !queue_is_empty(&mailbox->queue.queue);
+}
+
+static mailbox_t* mailbox_at(uint32_t slot) {
+    if (slot < MAILBOX_POOL_SIZE) {
+        return &default_pool[slot];
+    }
+    slot -= MAILBOX_POOL_SIZE;
+    return &chunks[slot / MAILBOX_CHUNK_SIZE][slot % MAILBOX_CHUNK_SIZE];
+}
+
+// Empties the table and returns every mailbox to the pool
+static void reset_locked(void) {
+    if (!initialized) {
+        timeout_cond_init(&created);
+        initialized = true;
+    }
+    if (!default_pool_ready) {
+        for (uint32_t i = 0; i < MAILBOX_POOL_SIZE; i++) {
+            blocking_queue_init(&default_pool[i].queue, MAILBOX_DEPTH);
+            default_pool[i].slot = i;
+        }
+        default_pool_ready = true;
+    }
+    
+    id_index_clear(&table);
+    table_used = 0;
+    free_list = NULL;
+    for (uint32_t i = pool_size; i-- > 0;) {
+        mailbox_t* mailbox = mailbox_at(i);
+        queue_clear(&mailbox->queue.queue);
+        mailbox->users = 0;
+        mailbox->waiting = false;
+        mailbox->closed = false;
+        mailbox->next_free = free_list;
+        free_list = mailbox;
+    }
+}
+
+// Adds a chunk of mailboxes to the free list, unless the pool already holds
+// one per task. Called with table_lock held.
+static bool pool_grow_locked(void) {
+    if (pool_size >= pool_limit) {
+        return false;
+    }
+    uint32_t count = pool_limit - pool_size;
+    if (count > MAILBOX_CHUNK_SIZE) {
+        count = MAILBOX_CHUNK_SIZE;
+    }
+    mailbox_t** grown = realloc(chunks, (chunk_count + 1) * sizeof(mailbox_t*));
+    if (!grown) {
+        return false;
+    }
+    chunks = grown;
+    mailbox_t* chunk = calloc(count, sizeof(mailbox_t));
+    if (!chunk) {
+        return false;
+    }
+    chunks[chunk_count++] = chunk;
+    for (uint32_t i = count; i-- > 0;) {
+        blocking_queue_init(&chunk[i].queue, MAILBOX_DEPTH);
+        chunk[i].slot = pool_size + i;
+        chunk[i].next_free = free_list;
+        free_list = &chunk[i];
+    }
+    pool_size += count;
+    return true;
+}
+
+// Makes room for one more table entry, doubling the table before it gets
+// more than half full. Positions probed earlier are stale afterwards.
+static bool table_reserve_locked(void) {
+    if (2 * (table_used + 1) <= table.mask + 1) {
+        return true;
+    }
+    uint32_t size = 2 * (table.mask + 1);
+    id_index_t grown = { malloc(size * sizeof(uint32_t)), malloc(size * sizeof(uint32_t)), size - 1 };
+    if (!grown.keys || !grown.slots) {
+        free(grown.keys);
+        free(grown.slots);
+        return false;
+    }
+    id_index_clear(&grown);
+    for (uint32_t i = 0; i <= table.mask; i++) {
+        if (table.slots[i] != ID_INDEX_FREE) {
+            uint32_t pos = id_index_probe(&grown, table.keys[i]);
+            grown.keys[pos] = table.keys[i];
+            grown.slots[pos] = table.slots[i];
+        }
+    }
+    if (table.keys != default_table_keys) {
+        free(table.keys);
+        free(table.slots);
+    }
+    table = grown;
+    return true;
+}
+
+static void table_remove_locked(uint32_t pos) {
+    id_index_remove(&table, pos);
+    table_used--;
+}
+
+static uint32_t table_probe(uint32_t task_id) {
+    return id_index_probe(&table, task_id);
+}
+
+// Takes a reference on the task's mailbox, first taking one from the pool
+// for an existing task that has none yet if create is set. The mailbox is
+// not recycled while references are held. Called with table_lock held.
+static mailbox_t* acquire_locked(uint32_t task_id, bool create) {
+    uint32_t pos = table_probe(task_id);
+    if (pos == ID_INDEX_NONE) {
+        return NULL;
+    }
+    uint32_t slot = table.slots[pos];
+    if (slot == ID_INDEX_FREE || slot == SLOT_PENDING) {
+        if (!create || !task_get(task_id) || (!free_list && !pool_grow_locked())) {
+            return NULL;
+        }
+        // A pending entry means the owner is already parked in a receive
+        bool waiting = slot == SLOT_PENDING;
+        if (slot == ID_INDEX_FREE) {
+            if (!table_reserve_locked()) {
+                return NULL;
+            }
+            pos = table_probe(task_id);
+            table_used++;
+        }
+        mailbox_t* mailbox = free_list;
+        free_list = mailbox->next_free;
+        table.keys[pos] = task_id;
+        table.slots[pos] = mailbox->slot;
+        mailbox->owner = task_id;
+        mailbox->waiting = waiting;
+        mailbox->closed = false;
+        if (waiting) {
+            pthread_cond_broadcast(&created);
+        }
+        slot = mailbox->slot;
+    }
+    mailbox_t* mailbox = mailbox_at(slot);
+    mailbox->users++;
+    return mailbox;
+}
+
+// Drops a reference; the last one out of a released mailbox returns it to
+// the pool
+static void mailbox_put(mailbox_t* mailbox) {
+    pthread_mutex_lock(&table_lock);
+    if (--mailbox->users == 0 && mailbox->closed) {
+        mailbox->next_free = free_list;
+        free_list = mailbox;
+    }
+    pthread_mutex_unlock(&table_lock);
+}
+
+static bool first_send_done(const void* ctx) {
+    uint32_t pos = table_probe(*(const uint32_t*)ctx);
+    return pos == ID_INDEX_NONE || table.slots[pos] != SLOT_PENDING;
+}
+
+// Parks a receiver whose task has no mailbox yet under a pending entry
+// until a send creates one, the task is deleted or the timeout expires.
+// Called with table_lock held.
+static mailbox_t* await_first_send(uint32_t task_id, uint32_t timeout_ms) {
+    uint32_t pos = table_probe(task_id);
+    if (pos != ID_INDEX_NONE && table.slots[pos] == ID_INDEX_FREE) {
+        pos = table_reserve_locked() ? table_probe(task_id) : ID_INDEX_NONE;
+        if (pos != ID_INDEX_NONE) {
+            table.keys[pos] = task_id;
+            table.slots[pos] = SLOT_PENDING;
+            table_used++;
+        }
+    }
+    if (pos == ID_INDEX_NONE) {
+        return NULL;
+    }
+    
+    timeout_wait(&created, &table_lock, timeout_ms, first_send_done, &task_id);
+    pos = table_probe(task_id);
+    if (pos != ID_INDEX_NONE && table.slots[pos] == SLOT_PENDING) {
+        table_remove_locked(pos);
+        return NULL;
+    }
+    return acquire_locked(task_id, false);
+}
+
+void mailbox_init(void) {
+    mailbox_init_capacity(MAILBOX_POOL_SIZE);
+}
+
+// Limits the pool to capacity mailboxes, one per task the task manager can
+// hold, and empties it; nothing is allocated until sends need it. Called by
+// task_manager_init_capacity; like it, must not run while mailboxes are in
+// use.
+bool mailbox_init_capacity(uint32_t capacity) {
+    if (capacity == 0) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&table_lock);
+    for (uint32_t c = 0; c < chunk_count; c++) {
+        uint32_t first = MAILBOX_POOL_SIZE + c * MAILBOX_CHUNK_SIZE;
+        for (uint32_t i = 0; first + i < pool_size && i < MAILBOX_CHUNK_SIZE; i++) {
+            blocking_queue_destroy(&chunks[c][i].queue);
+        }
+        free(chunks[c]);
+    }
+    free(chunks);
+    chunks = NULL;
+    chunk_count = 0;
+    pool_size = MAILBOX_POOL_SIZE;
+    pool_limit = capacity;
+    if (table.keys != default_table_keys) {
+        free(table.keys);
+        free(table.slots);
+        table.keys = default_table_keys;
+        table.slots = default_table_slots;
+        table.mask = MAILBOX_TABLE_SIZE - 1;
+    }
+    reset_locked();
+    pthread_mutex_unlock(&table_lock);
+    return true;
+}
+
+bool mailbox_send(uint32_t task_id, uint8_t msg, uint32_t timeout_ms) {
+    pthread_mutex_lock(&table_lock);
+    if (!initialized) {
+        reset_locked();
+    }
+    mailbox_t* mailbox = acquire_locked(task_id, true);
+    pthread_mutex_unlock(&table_lock);
+    if (!mailbox) {
+        return false;
+    }
+    
+    blocking_queue_t* bq = &mailbox->queue;
+    pthread_mutex_lock(&bq->lock);
+    bool sent = timeout_wait(&bq->not_full, &bq->lock, timeout_ms, has_space, mailbox) &&
+                !mailbox->closed && queue_enqueue(&bq->queue, msg);
+    if (sent) {
+        pthread_cond_signal(&bq->not_empty);
+        if (mailbox->waiting) {
+            mailbox->waiting = false;
+            task_set_state(mailbox->owner, TASK_READY);
+        }
+    }
+    pthread_mutex_unlock(&bq->lock);
+    mailbox_put(mailbox);
+    return sent;
+}
+
+// Receives never take a mailbox from the pool: before the first send to
+// the task there is only a pending entry to wait under
+bool mailbox_receive(uint32_t task_id, uint8_t* msg, uint32_t timeout_ms) {
+    if (!msg) {
+        return false;
+    }
+    
+    bool blocked = false;
+    pthread_mutex_lock(&table_lock);
+    if (!initialized) {
+        reset_locked();
+    }
+    mailbox_t* mailbox = acquire_locked(task_id, false);
+    if (!mailbox && timeout_ms != QUEUE_NO_WAIT && task_get(task_id)) {
+        uint64_t start_ns = timestamp_now_ns();
+        blocked = true;
+        task_set_state(task_id, TASK_BLOCKED);
+        mailbox = await_first_send(task_id, timeout_ms);
+        if (timeout_ms != QUEUE_WAIT_FOREVER) {
+            uint64_t waited_ms = (timestamp_now_ns() - start_ns) / 1000000u;
+            timeout_ms = waited_ms < timeout_ms ? timeout_ms - (uint32_t)waited_ms : QUEUE_NO_WAIT;
+        }
+    }
+    pthread_mutex_unlock(&table_lock);
+    if (!mailbox) {
+        if (blocked) {
+            task_set_state(task_id, TASK_RUNNING);
+        }
+        return false;
+    }
+    
+    blocking_queue_t* bq = &mailbox->queue;
+    pthread_mutex_lock(&bq->lock);
+    if (queue_is_empty(&bq->queue) && timeout_ms != QUEUE_NO_WAIT && !mailbox->closed) {
+        blocked = true;
+        mailbox->waiting = true;
+        task_set_state(task_id, TASK_BLOCKED);
+    }
+    
+    bool received = timeout_wait(&bq->not_empty, &bq->lock, timeout_ms, has_items, mailbox) &&
+                    !mailbox->closed && queue_dequeue(&bq->queue, msg);
+    if (received) {
+        pthread_cond_signal(&bq->not_full);
+    }
+    if (blocked) {
+        // Woken by a send (already READY), a release or the timeout: the
+        // task runs again
+        mailbox->waiting = false;
+        task_set_state(task_id, TASK_RUNNING);
+    }
+    pthread_mutex_unlock(&bq->lock);
+    mailbox_put(mailbox);
+    return received;
+}
+
+uint32_t mailbox_pending(uint32_t task_id) {
+    uint32_t pending = 0;
+    pthread_mutex_lock(&table_lock);
+    if (initialized) {
+        uint32_t pos = table_probe(task_id);
+        uint32_t slot = pos == ID_INDEX_NONE ? ID_INDEX_FREE : table.slots[pos];
+        if (slot != ID_INDEX_FREE && slot != SLOT_PENDING) {
+            pending = blocking_queue_size(&mailbox_at(slot)->queue);
+        }
+    }
+    pthread_mutex_unlock(&table_lock);
+    return pending;
+}
+
+// Drops the task's mailbox and any messages left in it. Senders and
+// receivers still parked on it are woken and fail; the mailbox goes back
+// to the pool once the last of them has left.
+void mailbox_release(uint32_t task_id) {
+    pthread_mutex_lock(&table_lock);
+    if (initialized) {
+        uint32_t pos = table_probe(task_id);
+        uint32_t slot = pos == ID_INDEX_NONE ? ID_INDEX_FREE : table.slots[pos];
+        if (slot == SLOT_PENDING) {
+            table_remove_locked(pos);
+            pthread_cond_broadcast(&created);
+        } else if (slot != ID_INDEX_FREE) {
+            table_remove_locked(pos);
+            mailbox_t* mailbox = mailbox_at(slot);
+            pthread_mutex_lock(&mailbox->queue.lock);
+            queue_clear(&mailbox->queue.queue);
+            mailbox->closed = true;
+            pthread_cond_broadcast(&mailbox->queue.not_empty);
+            pthread_cond_broadcast(&mailbox->queue.not_full);
+            pthread_mutex_unlock(&mailbox->queue.lock);
+            if (mailbox->users == 0) {
+                mailbox->next_free = free_list;
+                free_list = mailbox;
+            }
+        }
+    }
+    pthread_mutex_unlock(&table_lock);
+}
@@ -0,0 +1,39 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "blocking_queue.h"
+#include "task_manager.h"
+
+#define MAILBOX_POOL_SIZE  MAX_TASKS  // static part of the pool
+#define MAILBOX_CHUNK_SIZE 64         // heap growth step past the static part
+#define MAILBOX_DEPTH      16
+#define MAILBOX_TABLE_SIZE 32  // initial; power of two, doubled at half full
+
+// Per-task mailbox, taken from a pool the first time a message is sent to
+// the task and returned when the task is deleted. The pool grows in chunks
+// as sends need it, up to one mailbox per task the task manager can hold. Routing is an
+// O(1) hash lookup by task_id. A receive on an empty mailbox shows the
+// owner as TASK_BLOCKED; the send that delivers to it makes it TASK_READY.
+// A receive before the first send waits for that send without taking a
+// mailbox. Deleting the task fails any send or receive still waiting.
+typedef struct mailbox {
+    blocking_queue_t queue;
+    uint32_t owner;
+    uint32_t users;    // sends and receives holding it, under the table lock
+    uint32_t slot;     // position in the pool, fixed once made
+    bool waiting;
+    bool closed;       // released with its task, back to the pool when unused
+    struct mailbox* next_free;
+} mailbox_t;
+
+// Function declarations
+void mailbox_init(void);
+bool mailbox_init_capacity(uint32_t capacity);
+bool mailbox_send(uint32_t task_id, uint8_t msg, uint32_t timeout_ms);
+bool mailbox_receive(uint32_t task_id, uint8_t* msg, uint32_t timeout_ms);
+uint32_t mailbox_pending(uint32_t task_id);
+void mailbox_release(uint32_t task_id);
+
+#endif // MAILBOX_H
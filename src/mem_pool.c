@@ -0,0 +1,216 @@
+#define _DEFAULT_SOURCE
+
+#include "mem_pool.h"
+#include <pthread.h>
+#include <sys/mman.h>
+
+// Shared state of one size class. Free blocks are linked through their
+// first word; blocks never handed out yet are carved from the arena in
+// address order.
+typedef struct {
+    pthread_mutex_t lock;
+    void* free_list;
+    uint32_t shared_free;
+    uint32_t carved;
+    uint32_t capacity;
+} __attribute__((aligned(64))) pool_class_t;
+
+typedef struct {
+    void* blocks[MEM_POOL_CACHE_SIZE];
+    uint32_t count;
+} thread_cache_t;
+
+static pool_class_t classes[MEM_POOL_CLASSES];
+static uint8_t* arena_base = NULL;
+static bool pool_ready = false;
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cache_key;
+
+static __thread thread_cache_t caches[MEM_POOL_CLASSES];
+static __thread bool cache_registered = false;
+
+static uint32_t class_block_size(uint32_t index) {
+    return MEM_POOL_MIN_BLOCK << index;
+}
+
+static uint8_t* class_arena(uint32_t index) {
+    return arena_base + (size_t)index * MEM_POOL_ARENA_SIZE;
+}
+
+// Smallest class holding size bytes, or -1 when none does
+static int class_for_size(size_t size) {
+    if (size == 0 || size > MEM_POOL_MAX_BLOCK) {
+        return -1;
+    }
+    if (size <= MEM_POOL_MIN_BLOCK) {
+        return 0;
+    }
+    return (32 - __builtin_clz((uint32_t)size - 1)) - MEM_POOL_MIN_SHIFT;
+}
+
+// Class owning ptr, or -1 for addresses outside the arenas
+static int class_for_ptr(const void* ptr) {
+    if (!arena_base || (const uint8_t*)ptr < arena_base) {
+        return -1;
+    }
+    size_t offset = (size_t)((const uint8_t*)ptr - arena_base);
+    if (offset >= (size_t)MEM_POOL_CLASSES * MEM_POOL_ARENA_SIZE) {
+        return -1;
+    }
+    uint32_t index = (uint32_t)(offset / MEM_POOL_ARENA_SIZE);
+    if ((offset % MEM_POOL_ARENA_SIZE) % class_block_size(index) != 0) {
+        return -1;
+    }
+    return (int)index;
+}
+
+static void thread_cache_release(void* arg) {
+    (void)arg;
+    mem_pool_thread_flush();
+}
+
+static void pool_setup(void) {
+    size_t total = (size_t)MEM_POOL_CLASSES * MEM_POOL_ARENA_SIZE;
+    void* base = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return;
+    }
+    if (pthread_key_create(&cache_key, thread_cache_release) != 0) {
+        munmap(base, total);
+        return;
+    }
+    
+    arena_base = base;
+    for (uint32_t i = 0; i < MEM_POOL_CLASSES; i++) {
+        pthread_mutex_init(&classes[i].lock, NULL);
+        classes[i].free_list = NULL;
+        classes[i].shared_free = 0;
+        classes[i].carved = 0;
+        classes[i].capacity = MEM_POOL_ARENA_SIZE / class_block_size(i);
+    }
+    pool_ready = true;
+}
+
+// Sets up the pool on first use and arranges for this thread's cache to be
+// flushed when it exits
+static bool thread_register(void) {
+    pthread_once(&pool_once, pool_setup);
+    if (!pool_ready) {
+        return false;
+    }
+    // Any non-NULL value makes the key destructor run at thread exit
+    pthread_setspecific(cache_key, caches);
+    cache_registered = true;
+    return true;
+}
+
+// Moves up to MEM_POOL_BATCH blocks from the shared list (or fresh arena
+// space) into the thread cache
+static void cache_refill(uint32_t index, thread_cache_t* cache) {
+    pool_class_t* cls = &classes[index];
+    uint32_t block_size = class_block_size(index);
+    
+    pthread_mutex_lock(&cls->lock);
+    while (cache->count < MEM_POOL_BATCH && cls->free_list) {
+        void* block = cls->free_list;
+        cls->free_list = *(void**)block;
+        cls->shared_free--;
+        cache->blocks[cache->count++] = block;
+    }
+    while (cache->count < MEM_POOL_BATCH && cls->carved < cls->capacity) {
+        cache->blocks[cache->count++] = class_arena(index) + (size_t)cls->carved * block_size;
+        cls->carved++;
+    }
+    pthread_mutex_unlock(&cls->lock);
+}
+
+// Returns n blocks from the top of the thread cache to the shared list
+static void cache_trim(uint32_t index, thread_cache_t* cache, uint32_t n) {
+    pool_class_t* cls = &classes[index];
+    
+    pthread_mutex_lock(&cls->lock);
+    while (n-- > 0 && cache->count > 0) {
+        void* block = cache->blocks[--cache->count];
+        *(void**)block = cls->free_list;
+        cls->free_list = block;
+        cls->shared_free++;
+    }
+    pthread_mutex_unlock(&cls->lock);
+}
+
+bool mem_pool_init(void) {
+    pthread_once(&pool_once, pool_setup);
+    return pool_ready;
+}
+
+void* mem_pool_alloc(size_t size) {
+    int index = class_for_size(size);
+    if (index < 0) {
+        return NULL;
+    }
+    if (!cache_registered && !thread_register()) {
+        return NULL;
+    }
+    
+    thread_cache_t* cache = &caches[index];
+    if (cache->count == 0) {
+        cache_refill((uint32_t)index, cache);
+        if (cache->count == 0) {
+            return NULL;
+        }
+    }
+    return cache->blocks[--cache->count];
+}
+
+void mem_pool_free(void* ptr) {
+    int index = class_for_ptr(ptr);
+    if (index < 0) {
+        return;
+    }
+    if (!cache_registered) {
+        thread_register();
+    }
+    
+    thread_cache_t* cache = &caches[index];
+    if (cache->count == MEM_POOL_CACHE_SIZE) {
+        cache_trim((uint32_t)index, cache, MEM_POOL_BATCH);
+    }
+    cache->blocks[cache->count++] = ptr;
+}
+
+size_t mem_pool_block_size(const void* ptr) {
+    int index = class_for_ptr(ptr);
+    return index < 0 ? 0 : class_block_size((uint32_t)index);
+}
+
+bool mem_pool_owns(const void* ptr) {
+    return class_for_ptr(ptr) >= 0;
+}
+
+// Hands every block cached by the calling thread back to the shared lists
+void mem_pool_thread_flush(void) {
+    if (!pool_ready) {
+        return;
+    }
+    for (uint32_t i = 0; i < MEM_POOL_CLASSES; i++) {
+        if (caches[i].count > 0) {
+            cache_trim(i, &caches[i], caches[i].count);
+        }
+    }
+}
+
+bool mem_pool_class_info(uint32_t class_index, mem_pool_class_info_t* info) {
+    if (!info || class_index >= MEM_POOL_CLASSES || !mem_pool_init()) {
+        return false;
+    }
+    
+    pool_class_t* cls = &classes[class_index];
+    pthread_mutex_lock(&cls->lock);
+    info->block_size = class_block_size(class_index);
+    info->capacity = cls->capacity;
+    info->carved = cls->carved;
+    info->shared_free = cls->shared_free;
+    pthread_mutex_unlock(&cls->lock);
+    return true;
+}
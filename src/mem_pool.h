@@ -0,0 +1,48 @@
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Size classes are the powers of two from MEM_POOL_MIN_BLOCK to
+// MEM_POOL_MAX_BLOCK; a request is served from the smallest class that fits
+#define MEM_POOL_MIN_SHIFT  4
+#define MEM_POOL_MAX_SHIFT  16
+#define MEM_POOL_MIN_BLOCK  (1u << MEM_POOL_MIN_SHIFT)
+#define MEM_POOL_MAX_BLOCK  (1u << MEM_POOL_MAX_SHIFT)
+#define MEM_POOL_CLASSES    (MEM_POOL_MAX_SHIFT - MEM_POOL_MIN_SHIFT + 1)
+
+// Address space reserved per class. Pages are only touched as blocks are
+// first handed out, so unused capacity costs no memory.
+#define MEM_POOL_ARENA_SIZE (4u * 1024u * 1024u)
+
+// Blocks a thread keeps per class, and how many move to or from the shared
+// free list at once when the cache runs empty or full
+#define MEM_POOL_CACHE_SIZE 32
+#define MEM_POOL_BATCH      16
+
+// Fixed-block allocator shared by the whole process. Each class has its own
+// arena, so mem_pool_free finds the class from the address alone. Every
+// thread allocates from and frees to a private cache without locking; only
+// refilling or trimming a cache takes the class lock, once per
+// MEM_POOL_BATCH blocks. Blocks cached by a thread are returned when it
+// exits. The pool never falls back to malloc: a request above
+// MEM_POOL_MAX_BLOCK, or one for an exhausted class, returns NULL.
+typedef struct {
+    uint32_t block_size;
+    uint32_t capacity;
+    uint32_t carved;
+    uint32_t shared_free;
+} mem_pool_class_info_t;
+
+// Function declarations
+bool mem_pool_init(void);
+void* mem_pool_alloc(size_t size);
+void mem_pool_free(void* ptr);
+size_t mem_pool_block_size(const void* ptr);
+bool mem_pool_owns(const void* ptr);
+void mem_pool_thread_flush(void);
+bool mem_pool_class_info(uint32_t class_index, mem_pool_class_info_t* info);
+
+#endif // MEM_POOL_H
@@ -0,0 +1,337 @@
+#define _GNU_SOURCE
+
+#include "metrics_page.h"
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char* const state_labels[TASK_STATE_COUNT] = {
+    "ready", "running", "blocked", "suspended"
+};
+
+static bool map_page(metrics_page_t* metrics, int fd, size_t size, bool writable) {
+    int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* base = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->page = base;
+    metrics->fd = fd;
+    metrics->writable = writable;
+    return true;
+}
+
+// Seqlock writer side, as task_manager's table_seq: readers that see an
+// odd or changed seq retry
+static void record_write(uint64_t* seq, void* dst, const void* src, size_t size) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(dst, src, size);
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+// Reader side: plain loads only, no system calls. Gives up after
+// METRICS_READ_RETRIES tries, e.g. if the publisher died mid-write.
+static bool record_read(const uint64_t* seq, void* dst, const void* src, size_t size) {
+    for (uint32_t tries = 0; tries < METRICS_READ_RETRIES; tries++) {
+        uint64_t before = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            continue;
+        }
+        memcpy(dst, src, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(seq, __ATOMIC_RELAXED) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A NULL name creates an anonymous memfd, shared by passing metrics->fd to
+// the reader (fork or SCM_RIGHTS)
+bool metrics_page_create(metrics_page_t* metrics, const char* name) {
+    if (!metrics) {
+        return false;
+    }
+    
+    int fd = name ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644)
+                  : memfd_create("metrics_page", MFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    
+    size_t size = sizeof(metrics_page_layout_t);
+    if (ftruncate(fd, (off_t)size) != 0 || !map_page(metrics, fd, size, true)) {
+        close(fd);
+        if (name) {
+            shm_unlink(name);
+        }
+        return false;
+    }
+    
+    // ftruncate zero-fills, so every record starts empty with an even seq
+    metrics_page_layout_t* page = metrics->page;
+    page->version = METRICS_PAGE_VERSION;
+    page->map_size = size;
+    
+    // Publishing the magic last marks the page as fully initialised
+    __atomic_store_n(&page->magic, METRICS_PAGE_MAGIC, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool metrics_page_attach(metrics_page_t* metrics, const char* name) {
+    if (!metrics || !name) {
+        return false;
+    }
+    
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (!metrics_page_attach_fd(metrics, fd)) {
+        close(fd);
+        return false;
+    }
+    return true;
+}
+
+// Maps the page read-only; the reader never writes to it
+bool metrics_page_attach_fd(metrics_page_t* metrics, int fd) {
+    struct stat st;
+    if (!metrics || fd < 0 || fstat(fd, &st) != 0 ||
+        (size_t)st.st_size != sizeof(metrics_page_layout_t)) {
+        return false;
+    }
+    
+    size_t size = (size_t)st.st_size;
+    if (!map_page(metrics, fd, size, false)) {
+        return false;
+    }
+    
+    // Reject pages of another layout version
+    const metrics_page_layout_t* page = metrics->page;
+    if (__atomic_load_n(&page->magic, __ATOMIC_ACQUIRE) != METRICS_PAGE_MAGIC ||
+        page->version != METRICS_PAGE_VERSION || page->map_size != size) {
+        munmap(metrics->page, size);
+        metrics->page = NULL;
+        return false;
+    }
+    return true;
+}
+
+void metrics_page_detach(metrics_page_t* metrics) {
+    if (metrics && metrics->page) {
+        munmap(metrics->page, sizeof(metrics_page_layout_t));
+        close(metrics->fd);
+        metrics->page = NULL;
+        metrics->fd = -1;
+    }
+}
+
+bool metrics_page_unlink(const char* name) {
+    return name && shm_unlink(name) == 0;
+}
+
+// Registers a queue to be sampled by metrics_page_publish. The queue must
+// outlive the registration.
+bool metrics_page_add_queue(metrics_page_t* metrics, const char* name, const queue_t* queue) {
+    if (!metrics || !metrics->page || !metrics->writable || !name || !queue) {
+        return false;
+    }
+    
+    metrics_page_layout_t* page = metrics->page;
+    uint32_t index = page->queue_count;
+    if (index >= METRICS_MAX_QUEUES) {
+        return false;
+    }
+    
+    metrics_queue_t value;
+    memset(&value, 0, sizeof(value));
+    strncpy(value.name, name, METRICS_NAME_LEN - 1);
+    value.capacity = queue->max_size;
+    metrics->queues[index] = queue;
+    record_write(&page->queues[index].seq, &page->queues[index].value, &value, sizeof(value));
+    __atomic_store_n(&page->queue_count, index + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void sample_queue(const queue_t* queue, metrics_queue_t* value) {
+    queue_stats_t stats;
+    value->depth = queue_size(queue);
+    value->capacity = queue->max_size;
+    value->has_stats = queue_get_stats(queue, &stats);
+    if (value->has_stats) {
+        value->high_watermark = stats.high_watermark;
+        value->enqueued = stats.enqueued;
+        value->dequeued = stats.dequeued;
+        value->full_failures = stats.full_failures;
+        value->empty_failures = stats.empty_failures;
+    }
+}
+
+// Samples the task manager, the latency histograms and the registered
+// queues into the page. Takes no locks: every source is read with its
+// lock-free query. Call from one thread at a time, e.g. a periodic timer.
+bool metrics_page_publish(metrics_page_t* metrics) {
+    if (!metrics || !metrics->page || !metrics->writable) {
+        return false;
+    }
+    
+    // Values are gathered first so each seqlock is odd only for a memcpy
+    metrics_page_layout_t* page = metrics->page;
+    task_state_counts_t counts;
+    task_get_state_counts(&counts);
+    record_write(&page->tasks.seq, &page->tasks.value, &counts, sizeof(counts));
+    
+    for (uint32_t p = 0; p < SCHED_LATENCY_PRIORITIES; p++) {
+        sched_latency_report_t report;
+        sched_latency_get(p, &report);
+        record_write(&page->latency[p].seq, &page->latency[p].value, &report, sizeof(report));
+    }
+    
+    for (uint32_t i = 0; i < page->queue_count; i++) {
+        metrics_queue_t value = page->queues[i].value;
+        sample_queue(metrics->queues[i], &value);
+        record_write(&page->queues[i].seq, &page->queues[i].value, &value, sizeof(value));
+    }
+    __atomic_store_n(&page->publish_count, page->publish_count + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Each record is consistent on its own; records are not a single
+// snapshot of each other. Returns false if a record stayed torn.
+bool metrics_page_read(const metrics_page_t* metrics, metrics_snapshot_t* snapshot) {
+    if (!metrics || !metrics->page || !snapshot) {
+        return false;
+    }
+    
+    const metrics_page_layout_t* page = metrics->page;
+    snapshot->publish_count = __atomic_load_n(&page->publish_count, __ATOMIC_ACQUIRE);
+    bool ok = record_read(&page->tasks.seq, &snapshot->tasks, &page->tasks.value,
+                          sizeof(snapshot->tasks));
+    for (uint32_t p = 0; p < SCHED_LATENCY_PRIORITIES && ok; p++) {
+        ok = record_read(&page->latency[p].seq, &snapshot->latency[p], &page->latency[p].value,
+                         sizeof(snapshot->latency[p]));
+    }
+    
+    snapshot->queue_count = __atomic_load_n(&page->queue_count, __ATOMIC_ACQUIRE);
+    if (snapshot->queue_count > METRICS_MAX_QUEUES) {
+        return false;
+    }
+    for (uint32_t i = 0; i < snapshot->queue_count && ok; i++) {
+        ok = record_read(&page->queues[i].seq, &snapshot->queues[i], &page->queues[i].value,
+                         sizeof(snapshot->queues[i]));
+        snapshot->queues[i].name[METRICS_NAME_LEN - 1] = '\0';
+    }
+    return ok;
+}
+
+// Label values escape backslash, double quote and newline
+static void write_label(FILE* out, const char* value) {
+    for (const char* c = value; *c; c++) {
+        if (*c == '\\' || *c == '"') {
+            fputc('\\', out);
+            fputc(*c, out);
+        } else if (*c == '\n') {
+            fputs("\\n", out);
+        } else {
+            fputc(*c, out);
+        }
+    }
+}
+
+static void write_header(FILE* out, const char* name, const char* type, const char* help) {
+    fprintf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void write_queue_metric(FILE* out, const metrics_snapshot_t* snapshot, const char* name,
+                               const char* type, const char* help, size_t offset, bool stats_only) {
+    write_header(out, name, type, help);
+    for (uint32_t i = 0; i < snapshot->queue_count; i++) {
+        const metrics_queue_t* queue = &snapshot->queues[i];
+        if (stats_only && !queue->has_stats) {
+            continue;
+        }
+        const uint8_t* field = (const uint8_t*)queue + offset;
+        uint64_t value = offset < offsetof(metrics_queue_t, enqueued) ? *(const uint32_t*)field
+                                                                      : *(const uint64_t*)field;
+        fprintf(out, "%s{queue=\"", name);
+        write_label(out, queue->name);
+        fprintf(out, "\"} %llu\n", (unsigned long long)value);
+    }
+}
+
+// Prometheus text exposition format, version 0.0.4. Wake latencies are a
+// summary: quantiles from the histogram plus the exact sum and count.
+bool metrics_write_prometheus(const metrics_snapshot_t* snapshot, FILE* out) {
+    if (!snapshot || !out) {
+        return false;
+    }
+    
+    write_header(out, "tasks", "gauge", "Tasks by state.");
+    for (uint32_t s = 0; s < TASK_STATE_COUNT; s++) {
+        fprintf(out, "tasks{state=\"%s\"} %u\n", state_labels[s], snapshot->tasks.per_state[s]);
+    }
+    write_header(out, "task_capacity", "gauge", "Task table capacity.");
+    fprintf(out, "task_capacity %u\n", snapshot->tasks.capacity);
+    write_header(out, "task_transitions_total", "counter", "Task state transitions.");
+    fprintf(out, "task_transitions_total %llu\n", (unsigned long long)snapshot->tasks.transitions);
+    
+    static const double quantiles[] = { 0.5, 0.99, 0.999 };
+    write_header(out, "task_wake_latency_seconds", "summary",
+                 "READY to RUNNING latency by priority.");
+    for (uint32_t p = 0; p < SCHED_LATENCY_PRIORITIES; p++) {
+        const sched_latency_report_t* report = &snapshot->latency[p];
+        if (report->count == 0) {
+            continue;
+        }
+        uint64_t values[] = { report->p50_ns, report->p99_ns, report->p999_ns };
+        for (uint32_t q = 0; q < 3; q++) {
+            fprintf(out, "task_wake_latency_seconds{priority=\"%u\",quantile=\"%g\"} %.9f\n",
+                    p, quantiles[q], (double)values[q] / 1e9);
+        }
+        fprintf(out, "task_wake_latency_seconds_sum{priority=\"%u\"} %.9f\n",
+                p, (double)report->sum_ns / 1e9);
+        fprintf(out, "task_wake_latency_seconds_count{priority=\"%u\"} %llu\n",
+                p, (unsigned long long)report->count);
+    }
+    write_header(out, "task_wake_latency_max_seconds", "gauge",
+                 "Largest READY to RUNNING latency by priority.");
+    for (uint32_t p = 0; p < SCHED_LATENCY_PRIORITIES; p++) {
+        if (snapshot->latency[p].count > 0) {
+            fprintf(out, "task_wake_latency_max_seconds{priority=\"%u\"} %.9f\n",
+                    p, (double)snapshot->latency[p].max_ns / 1e9);
+        }
+    }
+    write_header(out, "task_wake_latency_alarms_total", "counter",
+                 "Wake latencies over the alarm threshold by priority.");
+    for (uint32_t p = 0; p < SCHED_LATENCY_PRIORITIES; p++) {
+        if (snapshot->latency[p].count > 0) {
+            fprintf(out, "task_wake_latency_alarms_total{priority=\"%u\"} %llu\n",
+                    p, (unsigned long long)snapshot->latency[p].alarms);
+        }
+    }
+    
+    write_queue_metric(out, snapshot, "queue_depth", "gauge", "Items in the queue.",
+                       offsetof(metrics_queue_t, depth), false);
+    write_queue_metric(out, snapshot, "queue_capacity", "gauge", "Queue capacity.",
+                       offsetof(metrics_queue_t, capacity), false);
+    write_queue_metric(out, snapshot, "queue_high_watermark", "gauge", "Largest depth seen.",
+                       offsetof(metrics_queue_t, high_watermark), true);
+    write_queue_metric(out, snapshot, "queue_enqueued_total", "counter", "Items enqueued.",
+                       offsetof(metrics_queue_t, enqueued), true);
+    write_queue_metric(out, snapshot, "queue_dequeued_total", "counter", "Items dequeued.",
+                       offsetof(metrics_queue_t, dequeued), true);
+    write_queue_metric(out, snapshot, "queue_full_failures_total", "counter",
+                       "Enqueues rejected because the queue was full.",
+                       offsetof(metrics_queue_t, full_failures), true);
+    write_queue_metric(out, snapshot, "queue_empty_failures_total", "counter",
+                       "Dequeues rejected because the queue was empty.",
+                       offsetof(metrics_queue_t, empty_failures), true);
+    return !ferror(out);
+}
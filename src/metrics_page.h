@@ -0,0 +1,93 @@
+#ifndef METRICS_PAGE_H
+#define METRICS_PAGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "task_manager.h"
+#include "queue.h"
+#include "sched_latency.h"
+
+#define METRICS_PAGE_MAGIC    0x4352544du   // "MTRC"
+#define METRICS_PAGE_VERSION  2u
+#define METRICS_CACHE_LINE    64
+#define METRICS_MAX_QUEUES    32
+#define METRICS_NAME_LEN      32
+#define METRICS_READ_RETRIES  10000   // reader gives up on a record after this
+
+// Metrics of one registered queue. The counters are 0 and has_stats is 0
+// unless built with QUEUE_STATS.
+typedef struct {
+    char name[METRICS_NAME_LEN];
+    uint32_t depth;
+    uint32_t capacity;
+    uint32_t high_watermark;
+    uint32_t has_stats;
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t full_failures;
+    uint64_t empty_failures;
+} metrics_queue_t;
+
+// Each record is guarded by its own seqlock: seq is odd while the
+// publisher rewrites it. Records sit on separate cache lines, so readers
+// of one do not contend with writes to the next.
+typedef struct {
+    uint64_t seq __attribute__((aligned(METRICS_CACHE_LINE)));
+    task_state_counts_t value;
+} metrics_tasks_record_t;
+
+typedef struct {
+    uint64_t seq __attribute__((aligned(METRICS_CACHE_LINE)));
+    sched_latency_report_t value;
+} metrics_latency_record_t;
+
+typedef struct {
+    uint64_t seq __attribute__((aligned(METRICS_CACHE_LINE)));
+    metrics_queue_t value;
+} metrics_queue_record_t;
+
+// Layout of the shared mapping. Like shm_queue it holds no pointers, so
+// the reader can map it at any address.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t map_size;
+    uint32_t queue_count;
+    uint32_t reserved;
+    uint64_t publish_count;  // bumped by every metrics_page_publish
+    metrics_tasks_record_t tasks;
+    metrics_latency_record_t latency[SCHED_LATENCY_PRIORITIES];
+    metrics_queue_record_t queues[METRICS_MAX_QUEUES];
+} metrics_page_layout_t;
+
+// Process-local handle. The publishing side also keeps the registered
+// queues, which only it can dereference.
+typedef struct {
+    metrics_page_layout_t* page;
+    const queue_t* queues[METRICS_MAX_QUEUES];
+    int fd;
+    bool writable;
+} metrics_page_t;
+
+// Consistent copy of every record, filled by metrics_page_read
+typedef struct {
+    uint64_t publish_count;
+    task_state_counts_t tasks;
+    sched_latency_report_t latency[SCHED_LATENCY_PRIORITIES];
+    uint32_t queue_count;
+    metrics_queue_t queues[METRICS_MAX_QUEUES];
+} metrics_snapshot_t;
+
+// Function declarations
+bool metrics_page_create(metrics_page_t* metrics, const char* name);
+bool metrics_page_attach(metrics_page_t* metrics, const char* name);
+bool metrics_page_attach_fd(metrics_page_t* metrics, int fd);
+void metrics_page_detach(metrics_page_t* metrics);
+bool metrics_page_unlink(const char* name);
+bool metrics_page_add_queue(metrics_page_t* metrics, const char* name, const queue_t* queue);
+bool metrics_page_publish(metrics_page_t* metrics);
+bool metrics_page_read(const metrics_page_t* metrics, metrics_snapshot_t* snapshot);
+bool metrics_write_prometheus(const metrics_snapshot_t* snapshot, FILE* out);
+
+#endif // METRICS_PAGE_H
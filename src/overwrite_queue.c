@@ -0,0 +1,146 @@
+#include "overwrite_queue.h"
+#include <string.h>
+
+void overwrite_queue_init(overwrite_queue_t* queue, uint32_t size) {
+    if (!queue || size == 0 || size > QUEUE_MAX_SIZE) {
+        return;
+    }
+    
+    queue->head = 0;
+    queue->tail = 0;
+    queue->max_size = size;
+    queue->dropped = 0;
+    memset(queue->data, 0, sizeof(queue->data));
+}
+
+bool overwrite_queue_enqueue(overwrite_queue_t* queue, uint8_t item) {
+    if (!queue) {
+        return false;
+    }
+    
+    uint64_t tail = queue->tail;
+    uint64_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    if (tail - head >= queue->max_size) {
+        // Full: claim the oldest slot before overwriting it. If the CAS
+        // fails the consumer just took that item and the slot is free.
+        if (__atomic_compare_exchange_n(&queue->head, &head, head + 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+        }
+    }
+    
+    __atomic_store_n(&queue->data[tail % queue->max_size], item, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool overwrite_queue_dequeue(overwrite_queue_t* queue, uint8_t* item) {
+    if (!queue || !item) {
+        return false;
+    }
+    
+    uint64_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    for (;;) {
+        if (head == __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        
+        // The value only counts if head was not advanced past it meanwhile;
+        // on failure head is reloaded and we retry with the new oldest item
+        uint8_t value = __atomic_load_n(&queue->data[head % queue->max_size],
+                                        __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&queue->head, &head, head + 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *item = value;
+            return true;
+        }
+    }
+}
+
+uint32_t overwrite_queue_size(const overwrite_queue_t* queue) {
+    if (!queue) {
+        return 0;
+    }
+    
+    uint64_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    return (uint32_t)(tail - head);
+}
+
+uint32_t overwrite_queue_dropped(const overwrite_queue_t* queue) {
+    return queue ? __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED) : 0;
+}
+
+bool overwrite_mailbox_init(overwrite_mailbox_t* mailbox, uint32_t elem_size) {
+    if (!mailbox || elem_size == 0 || elem_size > OVERWRITE_MAILBOX_MAX_SIZE) {
+        return false;
+    }
+    
+    memset(mailbox->data, 0, sizeof(mailbox->data));
+    mailbox->elem_size = elem_size;
+    mailbox->seq = 0;
+    mailbox->received_seq = 0;
+    mailbox->dropped = 0;
+    return true;
+}
+
+void overwrite_mailbox_write(overwrite_mailbox_t* mailbox, const void* value) {
+    if (!mailbox || !value) {
+        return;
+    }
+    
+    // seq is odd while the slot is being written; each value ends on a new
+    // even seq, so received_seq != seq means an unreceived value is present
+    uint32_t seq = mailbox->seq;
+    if (seq != 0 && __atomic_load_n(&mailbox->received_seq, __ATOMIC_ACQUIRE) != seq) {
+        __atomic_fetch_add(&mailbox->dropped, 1, __ATOMIC_RELAXED);
+    }
+    
+    __atomic_store_n(&mailbox->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(mailbox->data, value, mailbox->elem_size);
+    uint32_t next = seq + 2;
+    if (next == 0) {
+        next = 2;
+    }
+    __atomic_store_n(&mailbox->seq, next, __ATOMIC_RELEASE);
+}
+
+// Copies a consistent snapshot of the slot and returns its sequence number
+static uint32_t mailbox_read(const overwrite_mailbox_t* mailbox, void* value) {
+    for (;;) {
+        uint32_t before = __atomic_load_n(&mailbox->seq, __ATOMIC_ACQUIRE);
+        if (before & 1u) {
+            continue;
+        }
+        memcpy(value, mailbox->data, mailbox->elem_size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&mailbox->seq, __ATOMIC_RELAXED) == before) {
+            return before;
+        }
+    }
+}
+
+bool overwrite_mailbox_peek(const overwrite_mailbox_t* mailbox, void* value) {
+    if (!mailbox || !value) {
+        return false;
+    }
+    return mailbox_read(mailbox, value) != 0;
+}
+
+bool overwrite_mailbox_receive(overwrite_mailbox_t* mailbox, void* value) {
+    if (!mailbox || !value) {
+        return false;
+    }
+    
+    uint32_t seq = mailbox_read(mailbox, value);
+    if (seq == 0 || seq == __atomic_load_n(&mailbox->received_seq, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    __atomic_store_n(&mailbox->received_seq, seq, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t overwrite_mailbox_dropped(const overwrite_mailbox_t* mailbox) {
+    return mailbox ? __atomic_load_n(&mailbox->dropped, __ATOMIC_RELAXED) : 0;
+}
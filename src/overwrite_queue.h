@@ -0,0 +1,47 @@
+#ifndef OVERWRITE_QUEUE_H
+#define OVERWRITE_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "queue.h"
+
+#define OVERWRITE_MAILBOX_MAX_SIZE 64
+
+// Lossy ring for newest-wins telemetry. The producer never fails: once the
+// ring is full each enqueue discards the oldest item and counts it in
+// dropped. Safe for one producer thread and one concurrent consumer thread;
+// head/tail are free-running 64-bit counters updated with atomics.
+typedef struct {
+    uint8_t data[QUEUE_MAX_SIZE];
+    uint64_t head;
+    uint64_t tail;
+    uint32_t max_size;
+    uint32_t dropped;
+} overwrite_queue_t;
+
+// Single-slot mailbox in the style of xQueueOverwrite/xQueuePeek. The
+// writer always replaces the value; readers use a sequence lock, so peeks
+// never block the writer. Writes that replace a value nobody received are
+// counted in dropped.
+typedef struct {
+    uint8_t data[OVERWRITE_MAILBOX_MAX_SIZE];
+    uint32_t elem_size;
+    uint32_t seq;
+    uint32_t received_seq;
+    uint32_t dropped;
+} overwrite_mailbox_t;
+
+// Function declarations
+void overwrite_queue_init(overwrite_queue_t* queue, uint32_t size);
+bool overwrite_queue_enqueue(overwrite_queue_t* queue, uint8_t item);
+bool overwrite_queue_dequeue(overwrite_queue_t* queue, uint8_t* item);
+uint32_t overwrite_queue_size(const overwrite_queue_t* queue);
+uint32_t overwrite_queue_dropped(const overwrite_queue_t* queue);
+
+bool overwrite_mailbox_init(overwrite_mailbox_t* mailbox, uint32_t elem_size);
+void overwrite_mailbox_write(overwrite_mailbox_t* mailbox, const void* value);
+bool overwrite_mailbox_peek(const overwrite_mailbox_t* mailbox, void* value);
+bool overwrite_mailbox_receive(overwrite_mailbox_t* mailbox, void* value);
+uint32_t overwrite_mailbox_dropped(const overwrite_mailbox_t* mailbox);
+
+#endif // OVERWRITE_QUEUE_H
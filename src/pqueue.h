@@ -0,0 +1,61 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PQUEUE_MAX_SIZE   256
+#define PQUEUE_HEAP_ARITY 4
+#define PQUEUE_LEVELS     32
+
+// Priority queues with the queue_t surface. Higher priority values are
+// dequeued first (as with FreeRTOS task priorities); items of equal
+// priority come out in FIFO order.
+
+// Array-backed d-ary heap: O(log n) enqueue and dequeue, any priority value
+typedef struct {
+    uint8_t item;
+    uint32_t priority;
+    uint32_t seq;
+} pqueue_heap_entry_t;
+
+typedef struct {
+    pqueue_heap_entry_t entries[PQUEUE_MAX_SIZE];
+    uint32_t count;
+    uint32_t max_size;
+    uint32_t next_seq;
+} pqueue_heap_t;
+
+// One FIFO list per priority level plus a bitmap of non-empty levels:
+// O(1) enqueue and dequeue, priorities limited to 0..PQUEUE_LEVELS-1
+typedef struct {
+    uint8_t item;
+    uint16_t next;
+} pqueue_bitmap_node_t;
+
+typedef struct {
+    pqueue_bitmap_node_t nodes[PQUEUE_MAX_SIZE];
+    uint16_t level_head[PQUEUE_LEVELS];
+    uint16_t level_tail[PQUEUE_LEVELS];
+    uint32_t ready_levels;
+    uint16_t free_head;
+    uint32_t count;
+    uint32_t max_size;
+} pqueue_bitmap_t;
+
+// Function declarations
+void pqueue_heap_init(pqueue_heap_t* pq, uint32_t size);
+bool pqueue_heap_enqueue(pqueue_heap_t* pq, uint8_t item, uint32_t priority);
+bool pqueue_heap_dequeue(pqueue_heap_t* pq, uint8_t* item);
+bool pqueue_heap_is_empty(const pqueue_heap_t* pq);
+bool pqueue_heap_is_full(const pqueue_heap_t* pq);
+uint32_t pqueue_heap_size(const pqueue_heap_t* pq);
+
+void pqueue_bitmap_init(pqueue_bitmap_t* pq, uint32_t size);
+bool pqueue_bitmap_enqueue(pqueue_bitmap_t* pq, uint8_t item, uint32_t priority);
+bool pqueue_bitmap_dequeue(pqueue_bitmap_t* pq, uint8_t* item);
+bool pqueue_bitmap_is_empty(const pqueue_bitmap_t* pq);
+bool pqueue_bitmap_is_full(const pqueue_bitmap_t* pq);
+uint32_t pqueue_bitmap_size(const pqueue_bitmap_t* pq);
+
+#endif // PQUEUE_H
@@ -0,0 +1,78 @@
+#include "pqueue.h"
+
+#define PQUEUE_NIL UINT16_MAX
+
+void pqueue_bitmap_init(pqueue_bitmap_t* pq, uint32_t size) {
+    if (!pq || size > PQUEUE_MAX_SIZE) {
+        return;
+    }
+    
+    // Chain every node into the free list
+    for (uint32_t i = 0; i < PQUEUE_MAX_SIZE; i++) {
+        pq->nodes[i].next = (i + 1 < PQUEUE_MAX_SIZE) ? (uint16_t)(i + 1) : PQUEUE_NIL;
+    }
+    for (uint32_t level = 0; level < PQUEUE_LEVELS; level++) {
+        pq->level_head[level] = PQUEUE_NIL;
+        pq->level_tail[level] = PQUEUE_NIL;
+    }
+    pq->free_head = 0;
+    pq->ready_levels = 0;
+    pq->count = 0;
+    pq->max_size = size;
+}
+
+bool pqueue_bitmap_enqueue(pqueue_bitmap_t* pq, uint8_t item, uint32_t priority) {
+    if (!pq || priority >= PQUEUE_LEVELS || pqueue_bitmap_is_full(pq)) {
+        return false;
+    }
+    
+    uint16_t node = pq->free_head;
+    pq->free_head = pq->nodes[node].next;
+    pq->nodes[node].item = item;
+    pq->nodes[node].next = PQUEUE_NIL;
+    
+    // Append to the tail of this level's FIFO
+    if (pq->level_tail[priority] == PQUEUE_NIL) {
+        pq->level_head[priority] = node;
+        pq->ready_levels |= 1u << priority;
+    } else {
+        pq->nodes[pq->level_tail[priority]].next = node;
+    }
+    pq->level_tail[priority] = node;
+    pq->count++;
+    return true;
+}
+
+bool pqueue_bitmap_dequeue(pqueue_bitmap_t* pq, uint8_t* item) {
+    if (!pq || !item || pqueue_bitmap_is_empty(pq)) {
+        return false;
+    }
+    
+    // Highest set bit is the highest non-empty priority level
+    uint32_t level = 31u - (uint32_t)__builtin_clz(pq->ready_levels);
+    uint16_t node = pq->level_head[level];
+    
+    *item = pq->nodes[node].item;
+    pq->level_head[level] = pq->nodes[node].next;
+    if (pq->level_head[level] == PQUEUE_NIL) {
+        pq->level_tail[level] = PQUEUE_NIL;
+        pq->ready_levels &= ~(1u << level);
+    }
+    
+    pq->nodes[node].next = pq->free_head;
+    pq->free_head = node;
+    pq->count--;
+    return true;
+}
+
+bool pqueue_bitmap_is_empty(const pqueue_bitmap_t* pq) {
+    return pq ? (pq->count == 0) : true;
+}
+
+bool pqueue_bitmap_is_full(const pqueue_bitmap_t* pq) {
+    return pq ? (pq->count >= pq->max_size) : false;
+}
+
+uint32_t pqueue_bitmap_size(const pqueue_bitmap_t* pq) {
+    return pq ? pq->count : 0;
+}
@@ -0,0 +1,90 @@
+#include "pqueue.h"
+
+// a is served before b: higher priority first, then lower sequence number.
+// The signed difference keeps FIFO order correct across seq wrap-around.
+static bool entry_before(const pqueue_heap_entry_t* a, const pqueue_heap_entry_t* b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+void pqueue_heap_init(pqueue_heap_t* pq, uint32_t size) {
+    if (!pq || size > PQUEUE_MAX_SIZE) {
+        return;
+    }
+    
+    pq->count = 0;
+    pq->max_size = size;
+    pq->next_seq = 0;
+}
+
+bool pqueue_heap_enqueue(pqueue_heap_t* pq, uint8_t item, uint32_t priority) {
+    if (!pq || pqueue_heap_is_full(pq)) {
+        return false;
+    }
+    
+    pqueue_heap_entry_t entry = { item, priority, pq->next_seq++ };
+    
+    // Sift up, moving parents down instead of swapping
+    uint32_t i = pq->count++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / PQUEUE_HEAP_ARITY;
+        if (!entry_before(&entry, &pq->entries[parent])) {
+            break;
+        }
+        pq->entries[i] = pq->entries[parent];
+        i = parent;
+    }
+    pq->entries[i] = entry;
+    return true;
+}
+
+bool pqueue_heap_dequeue(pqueue_heap_t* pq, uint8_t* item) {
+    if (!pq || !item || pqueue_heap_is_empty(pq)) {
+        return false;
+    }
+    
+    *item = pq->entries[0].item;
+    pqueue_heap_entry_t last = pq->entries[--pq->count];
+    
+    // Sift the last entry down from the root
+    uint32_t i = 0;
+    for (;;) {
+        uint32_t first = i * PQUEUE_HEAP_ARITY + 1;
+        if (first >= pq->count) {
+            break;
+        }
+        
+        uint32_t best = first;
+        uint32_t end = first + PQUEUE_HEAP_ARITY;
+        if (end > pq->count) {
+            end = pq->count;
+        }
+        for (uint32_t c = first + 1; c < end; c++) {
+            if (entry_before(&pq->entries[c], &pq->entries[best])) {
+                best = c;
+            }
+        }
+        
+        if (!entry_before(&pq->entries[best], &last)) {
+            break;
+        }
+        pq->entries[i] = pq->entries[best];
+        i = best;
+    }
+    pq->entries[i] = last;
+    return true;
+}
+
+bool pqueue_heap_is_empty(const pqueue_heap_t* pq) {
+    return pq ? (pq->count == 0) : true;
+}
+
+bool pqueue_heap_is_full(const pqueue_heap_t* pq) {
+    return pq ? (pq->count >= pq->max_size) : false;
+}
+
+uint32_t pqueue_heap_size(const pqueue_heap_t* pq) {
+    return pq ? pq->count : 0;
+}
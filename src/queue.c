@@ -1,6 +1,52 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "queue.h"
+#include "timestamp.h"
+#include "trace.h"
 #include <string.h>
 
+#ifdef QUEUE_STATS
+// Queue operations are serialised by their callers, so counters only need
+// tear-free updates for concurrent readers: a relaxed load and store, with
+// no locked read-modify-write on the hot path.
+#define STAT_ADD(field, n) \
+    __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+
+static void stats_on_enqueue(queue_t* queue, uint32_t slot, uint32_t n) {
+    uint64_t now = timestamp_now_ticks();
+    for (uint32_t i = 0; i < n; i++) {
+        queue->enqueue_ticks[slot + i] = now;
+    }
+    STAT_ADD(queue->stats.enqueued, n);
+    if (queue->count > queue->stats.high_watermark) {
+        __atomic_store_n(&queue->stats.high_watermark, queue->count, __ATOMIC_RELAXED);
+    }
+}
+
+static void stats_on_dequeue(queue_t* queue, uint32_t slot, uint32_t n) {
+    uint64_t now = timestamp_now_ticks();
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t dwell = timestamp_ticks_to_ns(now - queue->enqueue_ticks[slot + i]);
+        uint32_t bucket = dwell ? 63u - (uint32_t)__builtin_clzll(dwell) : 0;
+        if (bucket >= QUEUE_STATS_BUCKETS) {
+            bucket = QUEUE_STATS_BUCKETS - 1;
+        }
+        STAT_ADD(queue->stats.dwell_histogram[bucket], 1);
+    }
+    STAT_ADD(queue->stats.dequeued, n);
+}
+
+#define STATS_ON_ENQUEUE(queue, slot, n) stats_on_enqueue((queue), (slot), (n))
+#define STATS_ON_DEQUEUE(queue, slot, n) stats_on_dequeue((queue), (slot), (n))
+#define STATS_ON_FULL(queue)             STAT_ADD((queue)->stats.full_failures, 1)
+#define STATS_ON_EMPTY(queue)            STAT_ADD((queue)->stats.empty_failures, 1)
+#else
+#define STATS_ON_ENQUEUE(queue, slot, n) ((void)(slot))
+#define STATS_ON_DEQUEUE(queue, slot, n) ((void)(slot))
+#define STATS_ON_FULL(queue)             ((void)0)
+#define STATS_ON_EMPTY(queue)            ((void)0)
+#endif
+
 void queue_init(queue_t* queue, uint32_t size) {
     if (!queue || size > QUEUE_MAX_SIZE) {
         return;
@@ -11,27 +57,45 @@ void queue_init(queue_t* queue, uint32_t size) {
     queue->count = 0;
     queue->max_size = size;
     memset(queue->data, 0, sizeof(queue->data));
+#ifdef QUEUE_STATS
+    timestamp_init();
+    memset(&queue->stats, 0, sizeof(queue->stats));
+#endif
 }
 
 bool queue_enqueue(queue_t* queue, uint8_t item) {
-    if (!queue || queue_is_full(queue)) {
+    if (!queue) {
+        return false;
+    }
+    if (queue_is_full(queue)) {
+        STATS_ON_FULL(queue);
         return false;
     }
     
-    queue->data[queue->tail] = item;
+    uint32_t slot = queue->tail;
+    queue->data[slot] = item;
     queue->tail = (queue->tail + 1) % queue->max_size;
     queue->count++;
+    STATS_ON_ENQUEUE(queue, slot, 1);
+    TRACE_EVENT(TRACE_QUEUE_ENQUEUE, (uintptr_t)queue, queue->count);
     return true;
 }
 
 bool queue_dequeue(queue_t* queue, uint8_t* item) {
-    if (!queue || !item || queue_is_empty(queue)) {
+    if (!queue || !item) {
+        return false;
+    }
+    if (queue_is_empty(queue)) {
+        STATS_ON_EMPTY(queue);
         return false;
     }
     
-    *item = queue->data[queue->head];
+    uint32_t slot = queue->head;
+    *item = queue->data[slot];
     queue->head = (queue->head + 1) % queue->max_size;
     queue->count--;
+    STATS_ON_DEQUEUE(queue, slot, 1);
+    TRACE_EVENT(TRACE_QUEUE_DEQUEUE, (uintptr_t)queue, queue->count);
     return true;
 }
 
@@ -53,4 +117,136 @@ void queue_clear(queue_t* queue) {
         queue->tail = 0;
         queue->count = 0;
     }
-}
\ No newline at end of file
+}
+
+static uint32_t queue_min(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+queue_span_t queue_reserve(queue_t* queue, uint32_t n) {
+    queue_span_t span = { NULL, 0 };
+    if (!queue || queue_is_full(queue)) {
+        return span;
+    }
+    
+    // Free space starts at tail and runs to the end of the buffer at most
+    uint32_t contiguous = queue_min(queue->max_size - queue->count,
+                                    queue->max_size - queue->tail);
+    span.data = &queue->data[queue->tail];
+    span.len = queue_min(n, contiguous);
+    return span;
+}
+
+bool queue_commit(queue_t* queue, uint32_t n) {
+    if (!queue || n > queue->max_size - queue->count ||
+        n > queue->max_size - queue->tail) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+    
+    uint32_t slot = queue->tail;
+    queue->tail = (queue->tail + n) % queue->max_size;
+    queue->count += n;
+    STATS_ON_ENQUEUE(queue, slot, n);
+    return true;
+}
+
+queue_span_t queue_read_acquire(queue_t* queue, uint32_t n) {
+    queue_span_t span = { NULL, 0 };
+    if (!queue || queue_is_empty(queue)) {
+        return span;
+    }
+    
+    // Pending items start at head and run to the end of the buffer at most
+    uint32_t contiguous = queue_min(queue->count, queue->max_size - queue->head);
+    span.data = &queue->data[queue->head];
+    span.len = queue_min(n, contiguous);
+    return span;
+}
+
+bool queue_read_release(queue_t* queue, uint32_t n) {
+    if (!queue || n > queue->count || n > queue->max_size - queue->head) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+    
+    uint32_t slot = queue->head;
+    queue->head = (queue->head + n) % queue->max_size;
+    queue->count -= n;
+    STATS_ON_DEQUEUE(queue, slot, n);
+    return true;
+}
+
+uint32_t queue_enqueue_bulk(queue_t* queue, const uint8_t* items, uint32_t n) {
+    if (!queue || !items) {
+        return 0;
+    }
+    
+    // At most two contiguous runs: up to the end of storage, then from 0
+    uint32_t done = 0;
+    for (int run = 0; run < 2 && done < n; run++) {
+        queue_span_t span = queue_reserve(queue, n - done);
+        if (span.len == 0) {
+            break;
+        }
+        memcpy(span.data, items + done, span.len);
+        queue_commit(queue, span.len);
+        done += span.len;
+    }
+    return done;
+}
+
+uint32_t queue_dequeue_bulk(queue_t* queue, uint8_t* items, uint32_t max) {
+    if (!queue || !items) {
+        return 0;
+    }
+    
+    uint32_t done = 0;
+    for (int run = 0; run < 2 && done < max; run++) {
+        queue_span_t span = queue_read_acquire(queue, max - done);
+        if (span.len == 0) {
+            break;
+        }
+        memcpy(items + done, span.data, span.len);
+        queue_read_release(queue, span.len);
+        done += span.len;
+    }
+    return done;
+}
+
+bool queue_get_stats(const queue_t* queue, queue_stats_t* stats) {
+#ifdef QUEUE_STATS
+    if (!queue || !stats) {
+        return false;
+    }
+    
+    stats->high_watermark = __atomic_load_n(&queue->stats.high_watermark, __ATOMIC_RELAXED);
+    stats->enqueued = __atomic_load_n(&queue->stats.enqueued, __ATOMIC_RELAXED);
+    stats->dequeued = __atomic_load_n(&queue->stats.dequeued, __ATOMIC_RELAXED);
+    stats->full_failures = __atomic_load_n(&queue->stats.full_failures, __ATOMIC_RELAXED);
+    stats->empty_failures = __atomic_load_n(&queue->stats.empty_failures, __ATOMIC_RELAXED);
+    for (uint32_t b = 0; b < QUEUE_STATS_BUCKETS; b++) {
+        stats->dwell_histogram[b] = __atomic_load_n(&queue->stats.dwell_histogram[b],
+                                                    __ATOMIC_RELAXED);
+    }
+    return true;
+#else
+    (void)queue;
+    (void)stats;
+    return false;
+#endif
+}
+
+void queue_reset_stats(queue_t* queue) {
+#ifdef QUEUE_STATS
+    if (queue) {
+        memset(&queue->stats, 0, sizeof(queue->stats));
+    }
+#else
+    (void)queue;
+#endif
+}
@@ -5,6 +5,19 @@
 #include <stdbool.h>
 
 #define QUEUE_MAX_SIZE 32
+#define QUEUE_STATS_BUCKETS 40
+
+// Per-queue statistics, collected only when built with -DQUEUE_STATS
+// (make STATS=1). Bucket b of dwell_histogram counts items that spent
+// [2^b, 2^(b+1)) ns between enqueue and dequeue; bucket 0 also takes 0 ns.
+typedef struct {
+    uint32_t high_watermark;
+    uint64_t enqueued;
+    uint64_t dequeued;
+    uint64_t full_failures;
+    uint64_t empty_failures;
+    uint64_t dwell_histogram[QUEUE_STATS_BUCKETS];
+} queue_stats_t;
 
 typedef struct {
     uint8_t data[QUEUE_MAX_SIZE];
@@ -12,8 +25,20 @@ typedef struct {
     uint32_t tail;
     uint32_t count;
     uint32_t max_size;
+#ifdef QUEUE_STATS
+    uint64_t enqueue_ticks[QUEUE_MAX_SIZE];
+    queue_stats_t stats;
+#endif
 } queue_t;
 
+// Contiguous window into the queue storage. A span never wraps: when the
+// region crosses the end of the buffer, len is shorter than requested and
+// the caller commits/releases it and asks again for the remainder.
+typedef struct {
+    uint8_t* data;
+    uint32_t len;
+} queue_span_t;
+
 // Function declarations
 void queue_init(queue_t* queue, uint32_t size);
 bool queue_enqueue(queue_t* queue, uint8_t item);
@@ -23,4 +48,18 @@ bool queue_is_full(const queue_t* queue);
 uint32_t queue_size(const queue_t* queue);
 void queue_clear(queue_t* queue);
 
+// Zero-copy producer/consumer access
+queue_span_t queue_reserve(queue_t* queue, uint32_t n);
+bool queue_commit(queue_t* queue, uint32_t n);
+queue_span_t queue_read_acquire(queue_t* queue, uint32_t n);
+bool queue_read_release(queue_t* queue, uint32_t n);
+
+// Bulk copies; return the number of items actually moved
+uint32_t queue_enqueue_bulk(queue_t* queue, const uint8_t* items, uint32_t n);
+uint32_t queue_dequeue_bulk(queue_t* queue, uint8_t* items, uint32_t max);
+
+// Statistics; queue_get_stats returns false when built without QUEUE_STATS
+bool queue_get_stats(const queue_t* queue, queue_stats_t* stats);
+void queue_reset_stats(queue_t* queue);
+
 #endif // QUEUE_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "queue_set.h"
+
+static bool has_events(const void* ctx) {
+    return ((const queue_set_t*)ctx)->count > 0;
+}
+
+bool queue_set_init(queue_set_t* set) {
+    if (!set) {
+        return false;
+    }
+    
+    set->head = 0;
+    set->tail = 0;
+    set->count = 0;
+    set->capacity = 0;
+    set->member_count = 0;
+    pthread_mutex_init(&set->lock, NULL);
+    timeout_cond_init(&set->not_empty);
+    return true;
+}
+
+void queue_set_destroy(queue_set_t* set) {
+    if (set) {
+        pthread_cond_destroy(&set->not_empty);
+        pthread_mutex_destroy(&set->lock);
+    }
+}
+
+bool queue_set_add(queue_set_t* set, blocking_queue_t* bq) {
+    if (!set || !bq) {
+        return false;
+    }
+    
+    // Like FreeRTOS, only empty queues that belong to no other set may join,
+    // so the ready list always holds exactly one entry per pending item
+    pthread_mutex_lock(&bq->lock);
+    pthread_mutex_lock(&set->lock);
+    bool added = bq->set == NULL && queue_is_empty(&bq->queue) &&
+                 set->member_count < QUEUE_SET_MAX_MEMBERS;
+    if (added) {
+        bq->set = set;
+        set->member_count++;
+        set->capacity += bq->queue.max_size;
+    }
+    pthread_mutex_unlock(&set->lock);
+    pthread_mutex_unlock(&bq->lock);
+    return added;
+}
+
+bool queue_set_remove(queue_set_t* set, blocking_queue_t* bq) {
+    if (!set || !bq) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&bq->lock);
+    pthread_mutex_lock(&set->lock);
+    bool removed = bq->set == set && queue_is_empty(&bq->queue);
+    if (removed) {
+        bq->set = NULL;
+        set->member_count--;
+        set->capacity -= bq->queue.max_size;
+    }
+    pthread_mutex_unlock(&set->lock);
+    pthread_mutex_unlock(&bq->lock);
+    return removed;
+}
+
+void queue_set_post(queue_set_t* set, blocking_queue_t* bq) {
+    pthread_mutex_lock(&set->lock);
+    if (set->count < set->capacity) {
+        set->ready[set->tail] = bq;
+        set->tail = (set->tail + 1) % QUEUE_SET_MAX_EVENTS;
+        set->count++;
+        pthread_cond_signal(&set->not_empty);
+    }
+    pthread_mutex_unlock(&set->lock);
+}
+
+blocking_queue_t* queue_set_select(queue_set_t* set, uint32_t timeout_ms) {
+    if (!set) {
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&set->lock);
+    timeout_wait(&set->not_empty, &set->lock, timeout_ms, has_events, set);
+    
+    blocking_queue_t* bq = NULL;
+    if (set->count > 0) {
+        bq = set->ready[set->head];
+        set->head = (set->head + 1) % QUEUE_SET_MAX_EVENTS;
+        set->count--;
+    }
+    pthread_mutex_unlock(&set->lock);
+    return bq;
+}
@@ -0,0 +1,38 @@
+#ifndef QUEUE_SET_H
+#define QUEUE_SET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "blocking_queue.h"
+
+#define QUEUE_SET_MAX_MEMBERS 64
+#define QUEUE_SET_MAX_EVENTS  (QUEUE_SET_MAX_MEMBERS * QUEUE_MAX_SIZE)
+
+// Set of blocking queues that can be waited on together, modelled on
+// FreeRTOS queue sets. Every item sent to a member queue posts that queue
+// to the set's ready list, so queue_set_select() is O(1) per event and
+// never scans the members. After select returns a queue, the caller must
+// receive exactly one item from it.
+typedef struct queue_set {
+    blocking_queue_t* ready[QUEUE_SET_MAX_EVENTS];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t member_count;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+} queue_set_t;
+
+// Function declarations
+bool queue_set_init(queue_set_t* set);
+void queue_set_destroy(queue_set_t* set);
+bool queue_set_add(queue_set_t* set, blocking_queue_t* bq);
+bool queue_set_remove(queue_set_t* set, blocking_queue_t* bq);
+blocking_queue_t* queue_set_select(queue_set_t* set, uint32_t timeout_ms);
+
+// Called by blocking_queue_send() with the member queue lock held
+void queue_set_post(queue_set_t* set, blocking_queue_t* bq);
+
+#endif // QUEUE_SET_H
@@ -0,0 +1,171 @@
+#include "sched_latency.h"
+#include <string.h>
+#include <pthread.h>
+
+typedef struct {
+    uint64_t counts[SCHED_LATENCY_BUCKETS];
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t alarms;
+    uint64_t threshold_ns;   // 0: alarm off
+    sched_latency_alarm_t callback;
+    void* arg;
+} latency_histogram_t;
+
+static latency_histogram_t histograms[SCHED_LATENCY_PRIORITIES];
+
+// Guards callback/arg pairs; thresholds are read without it on the hot path
+static pthread_mutex_t alarm_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Writers are serialised by the task lock, so counters only need tear-free
+// updates for lock-free readers, as in the queue statistics
+#define LATENCY_ADD(field, n) \
+    __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+
+static latency_histogram_t* histogram_for(uint32_t priority) {
+    if (priority >= SCHED_LATENCY_PRIORITIES) {
+        priority = SCHED_LATENCY_PRIORITIES - 1;
+    }
+    return &histograms[priority];
+}
+
+static uint32_t bucket_index(uint64_t ns) {
+    if (ns < SCHED_LATENCY_SUB_BUCKETS) {
+        return (uint32_t)ns;
+    }
+    uint32_t msb = 63u - (uint32_t)__builtin_clzll(ns);
+    if (msb >= SCHED_LATENCY_MAX_BITS) {
+        return SCHED_LATENCY_BUCKETS - 1;
+    }
+    uint32_t shift = msb - SCHED_LATENCY_SUB_BITS;
+    return (shift + 1) * SCHED_LATENCY_SUB_BUCKETS +
+           (uint32_t)((ns >> shift) & (SCHED_LATENCY_SUB_BUCKETS - 1));
+}
+
+// Largest value that maps to bucket index
+static uint64_t bucket_highest(uint32_t index) {
+    if (index < 2 * SCHED_LATENCY_SUB_BUCKETS) {
+        return index;
+    }
+    uint32_t shift = index / SCHED_LATENCY_SUB_BUCKETS - 1;
+    uint64_t sub = SCHED_LATENCY_SUB_BUCKETS + index % SCHED_LATENCY_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+bool sched_latency_record(uint32_t priority, uint64_t latency_ns) {
+    latency_histogram_t* histogram = histogram_for(priority);
+    LATENCY_ADD(histogram->counts[bucket_index(latency_ns)], 1);
+    LATENCY_ADD(histogram->sum_ns, latency_ns);
+    if (latency_ns > histogram->max_ns) {
+        __atomic_store_n(&histogram->max_ns, latency_ns, __ATOMIC_RELAXED);
+    }
+    
+    uint64_t threshold = __atomic_load_n(&histogram->threshold_ns, __ATOMIC_RELAXED);
+    if (threshold == 0 || latency_ns <= threshold) {
+        return false;
+    }
+    LATENCY_ADD(histogram->alarms, 1);
+    return true;
+}
+
+void sched_latency_alarm(uint32_t task_id, uint32_t priority, uint64_t latency_ns) {
+    latency_histogram_t* histogram = histogram_for(priority);
+    pthread_mutex_lock(&alarm_lock);
+    sched_latency_alarm_t callback = histogram->callback;
+    void* arg = histogram->arg;
+    pthread_mutex_unlock(&alarm_lock);
+    if (callback) {
+        callback(task_id, priority, latency_ns, arg);
+    }
+}
+
+// Value at percentile (0-100] of counts, clamped to max_ns; 0 if empty
+static uint64_t counts_percentile(const uint64_t* counts, uint64_t total,
+                                  uint64_t max_ns, double percentile) {
+    if (total == 0) {
+        return 0;
+    }
+    double exact = percentile / 100.0 * (double)total;
+    uint64_t rank = (uint64_t)exact;
+    if ((double)rank < exact || rank == 0) {
+        rank++;
+    }
+    
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < SCHED_LATENCY_BUCKETS; b++) {
+        seen += counts[b];
+        if (seen >= rank && b == SCHED_LATENCY_BUCKETS - 1) {
+            return max_ns;   // open-ended overflow bucket
+        }
+        if (seen >= rank) {
+            uint64_t value = bucket_highest(b);
+            return value < max_ns ? value : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+// Copies a histogram's counts and returns their total
+static uint64_t snapshot(const latency_histogram_t* histogram, uint64_t* counts,
+                         uint64_t* max_ns) {
+    uint64_t total = 0;
+    for (uint32_t b = 0; b < SCHED_LATENCY_BUCKETS; b++) {
+        counts[b] = __atomic_load_n(&histogram->counts[b], __ATOMIC_RELAXED);
+        total += counts[b];
+    }
+    *max_ns = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+    return total;
+}
+
+bool sched_latency_get(uint32_t priority, sched_latency_report_t* report) {
+    if (!report) {
+        return false;
+    }
+    
+    uint64_t counts[SCHED_LATENCY_BUCKETS];
+    const latency_histogram_t* histogram = histogram_for(priority);
+    report->count = snapshot(histogram, counts, &report->max_ns);
+    report->p50_ns = counts_percentile(counts, report->count, report->max_ns, 50.0);
+    report->p99_ns = counts_percentile(counts, report->count, report->max_ns, 99.0);
+    report->p999_ns = counts_percentile(counts, report->count, report->max_ns, 99.9);
+    report->sum_ns = __atomic_load_n(&histogram->sum_ns, __ATOMIC_RELAXED);
+    report->alarms = __atomic_load_n(&histogram->alarms, __ATOMIC_RELAXED);
+    return true;
+}
+
+uint64_t sched_latency_percentile(uint32_t priority, double percentile) {
+    if (percentile <= 0.0 || percentile > 100.0) {
+        return 0;
+    }
+    
+    uint64_t counts[SCHED_LATENCY_BUCKETS];
+    uint64_t max_ns;
+    uint64_t total = snapshot(histogram_for(priority), counts, &max_ns);
+    return counts_percentile(counts, total, max_ns, percentile);
+}
+
+// threshold_ns 0 turns the alarm off; callback may be NULL to only count
+bool sched_latency_set_alarm(uint32_t priority, uint64_t threshold_ns,
+                             sched_latency_alarm_t callback, void* arg) {
+    if (priority >= SCHED_LATENCY_PRIORITIES) {
+        return false;
+    }
+    
+    latency_histogram_t* histogram = &histograms[priority];
+    pthread_mutex_lock(&alarm_lock);
+    histogram->callback = callback;
+    histogram->arg = arg;
+    __atomic_store_n(&histogram->threshold_ns, threshold_ns, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&alarm_lock);
+    return true;
+}
+
+// Clears the recorded latencies; alarm settings are kept
+void sched_latency_reset(void) {
+    for (uint32_t p = 0; p < SCHED_LATENCY_PRIORITIES; p++) {
+        memset(histograms[p].counts, 0, sizeof(histograms[p].counts));
+        histograms[p].sum_ns = 0;
+        histograms[p].max_ns = 0;
+        histograms[p].alarms = 0;
+    }
+}
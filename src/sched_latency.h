@@ -0,0 +1,53 @@
+#ifndef SCHED_LATENCY_H
+#define SCHED_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Wake-to-run latency: the time a task spends between becoming TASK_READY
+// and reaching TASK_RUNNING, recorded by task_set_state into one histogram
+// per priority. Priorities at or above SCHED_LATENCY_PRIORITIES share the
+// last histogram.
+//
+// Histograms are HDR-style log-linear: values below 2^SUB_BITS ns are
+// exact, and every power of two above is split into 2^SUB_BITS linear
+// sub-buckets, so a reported percentile is within 1/2^SUB_BITS (about 3%)
+// of the true value. Latencies of 2^MAX_BITS ns (about 68 s) and over land
+// in the last bucket.
+
+#define SCHED_LATENCY_PRIORITIES  32
+#define SCHED_LATENCY_SUB_BITS    5
+#define SCHED_LATENCY_SUB_BUCKETS (1u << SCHED_LATENCY_SUB_BITS)
+#define SCHED_LATENCY_MAX_BITS    36
+#define SCHED_LATENCY_BUCKETS \
+    ((SCHED_LATENCY_MAX_BITS - SCHED_LATENCY_SUB_BITS + 1) * SCHED_LATENCY_SUB_BUCKETS)
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;         // total of all recorded latencies
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;         // exact, not bucketed
+    uint64_t alarms;         // latencies over the alarm threshold
+} sched_latency_report_t;
+
+// Called outside the task lock, from the thread that moved the task to
+// TASK_RUNNING, so it may use the task manager
+typedef void (*sched_latency_alarm_t)(uint32_t task_id, uint32_t priority,
+                                      uint64_t latency_ns, void* arg);
+
+// Function declarations
+bool sched_latency_get(uint32_t priority, sched_latency_report_t* report);
+uint64_t sched_latency_percentile(uint32_t priority, double percentile);
+bool sched_latency_set_alarm(uint32_t priority, uint64_t threshold_ns,
+                             sched_latency_alarm_t callback, void* arg);
+void sched_latency_reset(void);
+
+// Hooks for task_set_state: record runs under the task lock and returns
+// true when the latency is over the priority's alarm threshold; the task
+// manager then calls sched_latency_alarm once the lock is released
+bool sched_latency_record(uint32_t priority, uint64_t latency_ns);
+void sched_latency_alarm(uint32_t task_id, uint32_t priority, uint64_t latency_ns);
+
+#endif // SCHED_LATENCY_H
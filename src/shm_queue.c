@@ -0,0 +1,197 @@
+#define _GNU_SOURCE
+
+#include "shm_queue.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static size_t data_offset(void) {
+    size_t header = sizeof(shm_queue_header_t);
+    return (header + SHM_QUEUE_CACHE_LINE - 1) & ~(size_t)(SHM_QUEUE_CACHE_LINE - 1);
+}
+
+static bool map_segment(shm_queue_t* q, int fd, size_t size) {
+    void* base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    
+    q->header = base;
+    q->map_size = size;
+    q->fd = fd;
+    return true;
+}
+
+static void set_geometry(shm_queue_t* q, uint32_t capacity, uint32_t elem_size,
+                         uint64_t offset) {
+    q->capacity = capacity;
+    q->mask = capacity - 1;
+    q->elem_size = elem_size;
+    q->data = (uint8_t*)q->header + offset;
+}
+
+// Capacity must be a power of two so slots are found with a mask.
+// A NULL name creates an anonymous memfd, shared by passing q->fd to the
+// other process (fork or SCM_RIGHTS).
+bool shm_queue_create(shm_queue_t* q, const char* name, uint32_t capacity,
+                      uint32_t elem_size) {
+    if (!q || capacity == 0 || (capacity & (capacity - 1)) != 0 || elem_size == 0) {
+        return false;
+    }
+    
+    int fd = name ? shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600)
+                  : memfd_create("shm_queue", MFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    
+    size_t size = data_offset() + (size_t)capacity * elem_size;
+    if (ftruncate(fd, (off_t)size) != 0 || !map_segment(q, fd, size)) {
+        close(fd);
+        if (name) {
+            shm_unlink(name);
+        }
+        return false;
+    }
+    
+    shm_queue_header_t* header = q->header;
+    header->version = SHM_QUEUE_VERSION;
+    header->capacity = capacity;
+    header->elem_size = elem_size;
+    header->data_offset = data_offset();
+    header->map_size = size;
+    header->head = 0;
+    header->tail = 0;
+    
+    // Publishing the magic last marks the header as fully initialised
+    __atomic_store_n(&header->magic, SHM_QUEUE_MAGIC, __ATOMIC_RELEASE);
+    
+    set_geometry(q, capacity, elem_size, data_offset());
+    q->cached_head = 0;
+    q->cached_tail = 0;
+    return true;
+}
+
+bool shm_queue_attach(shm_queue_t* q, const char* name) {
+    if (!q || !name) {
+        return false;
+    }
+    
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (!shm_queue_attach_fd(q, fd)) {
+        close(fd);
+        return false;
+    }
+    return true;
+}
+
+bool shm_queue_attach_fd(shm_queue_t* q, int fd) {
+    struct stat st;
+    if (!q || fd < 0 || fstat(fd, &st) != 0 ||
+        (size_t)st.st_size < sizeof(shm_queue_header_t)) {
+        return false;
+    }
+    
+    size_t size = (size_t)st.st_size;
+    if (!map_segment(q, fd, size)) {
+        return false;
+    }
+    
+    // Each field is read once: the peer may change the header under us, so
+    // only the values checked here are ever used
+    shm_queue_header_t* header = q->header;
+    bool valid = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) == SHM_QUEUE_MAGIC &&
+                 __atomic_load_n(&header->version, __ATOMIC_RELAXED) == SHM_QUEUE_VERSION;
+    uint32_t capacity = __atomic_load_n(&header->capacity, __ATOMIC_RELAXED);
+    uint32_t elem_size = __atomic_load_n(&header->elem_size, __ATOMIC_RELAXED);
+    uint64_t offset = __atomic_load_n(&header->data_offset, __ATOMIC_RELAXED);
+    uint64_t map_size = __atomic_load_n(&header->map_size, __ATOMIC_RELAXED);
+    
+    // Reject segments of another layout version or with an inconsistent size
+    valid = valid && map_size == size && capacity != 0 && (capacity & (capacity - 1)) == 0 &&
+            elem_size != 0 && offset >= sizeof(shm_queue_header_t) && offset <= size &&
+            (uint64_t)capacity * elem_size <= size - offset;
+    if (!valid) {
+        munmap(header, size);
+        q->header = NULL;
+        return false;
+    }
+    
+    set_geometry(q, capacity, elem_size, offset);
+    q->cached_head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+    q->cached_tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+void shm_queue_detach(shm_queue_t* q) {
+    if (q && q->header) {
+        munmap(q->header, q->map_size);
+        close(q->fd);
+        q->header = NULL;
+        q->data = NULL;
+        q->fd = -1;
+    }
+}
+
+bool shm_queue_unlink(const char* name) {
+    return name && shm_unlink(name) == 0;
+}
+
+bool shm_queue_enqueue(shm_queue_t* q, const void* item) {
+    if (!q || !q->header || !item) {
+        return false;
+    }
+    
+    shm_queue_header_t* header = q->header;
+    uint64_t tail = __atomic_load_n(&header->tail, __ATOMIC_RELAXED);
+    
+    // Only re-read the consumer's head when the cached copy says full
+    if (tail - q->cached_head >= q->capacity) {
+        q->cached_head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+        if (tail - q->cached_head >= q->capacity) {
+            return false;
+        }
+    }
+    
+    uint32_t slot = (uint32_t)tail & q->mask;
+    memcpy(q->data + (size_t)slot * q->elem_size, item, q->elem_size);
+    __atomic_store_n(&header->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool shm_queue_dequeue(shm_queue_t* q, void* item) {
+    if (!q || !q->header || !item) {
+        return false;
+    }
+    
+    shm_queue_header_t* header = q->header;
+    uint64_t head = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+    
+    // Only re-read the producer's tail when the cached copy says empty
+    if (head == q->cached_tail) {
+        q->cached_tail = __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE);
+        if (head == q->cached_tail) {
+            return false;
+        }
+    }
+    
+    uint32_t slot = (uint32_t)head & q->mask;
+    memcpy(item, q->data + (size_t)slot * q->elem_size, q->elem_size);
+    __atomic_store_n(&header->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t shm_queue_size(const shm_queue_t* q) {
+    if (!q || !q->header) {
+        return 0;
+    }
+    
+    uint64_t head = __atomic_load_n(&q->header->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = __atomic_load_n(&q->header->tail, __ATOMIC_ACQUIRE);
+    return tail - head > q->capacity ? q->capacity : (uint32_t)(tail - head);
+}
@@ -0,0 +1,56 @@
+#ifndef SHM_QUEUE_H
+#define SHM_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SHM_QUEUE_MAGIC      0x514d4853u  // "SHMQ"
+#define SHM_QUEUE_VERSION    1u
+#define SHM_QUEUE_CACHE_LINE 64
+
+// Layout at the start of the shared mapping. Only offsets are stored, never
+// pointers, so every process can map the segment at a different address.
+// head and tail sit on their own cache lines to avoid false sharing
+// between the producer and consumer processes.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t elem_size;
+    uint64_t data_offset;
+    uint64_t map_size;
+    uint64_t head __attribute__((aligned(SHM_QUEUE_CACHE_LINE)));
+    uint64_t tail __attribute__((aligned(SHM_QUEUE_CACHE_LINE)));
+} shm_queue_header_t;
+
+// Single-producer/single-consumer ring of fixed-size records in a memfd or
+// POSIX shared memory segment. After create/attach, enqueue and dequeue are
+// plain loads, stores and memcpy with no system calls.
+//
+// The geometry is validated once and kept in process memory: the peer can
+// still write the shared header, so only head and tail are read from it.
+typedef struct {
+    shm_queue_header_t* header;
+    uint8_t* data;
+    uint64_t cached_head;
+    uint64_t cached_tail;
+    uint64_t map_size;
+    uint32_t capacity;
+    uint32_t mask;
+    uint32_t elem_size;
+    int fd;
+} shm_queue_t;
+
+// Function declarations
+bool shm_queue_create(shm_queue_t* q, const char* name, uint32_t capacity,
+                      uint32_t elem_size);
+bool shm_queue_attach(shm_queue_t* q, const char* name);
+bool shm_queue_attach_fd(shm_queue_t* q, int fd);
+void shm_queue_detach(shm_queue_t* q);
+bool shm_queue_unlink(const char* name);
+bool shm_queue_enqueue(shm_queue_t* q, const void* item);
+bool shm_queue_dequeue(shm_queue_t* q, void* item);
+uint32_t shm_queue_size(const shm_queue_t* q);
+
+#endif // SHM_QUEUE_H
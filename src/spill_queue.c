@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "spill_queue.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+static uint32_t queue_counter = 0;
+
+static void segment_path(const spill_queue_t* sq, uint32_t index, char* path, size_t len) {
+    snprintf(path, len, "%s/spill-%s-%08u.seg", sq->dir, sq->tag, index);
+}
+
+static bool segment_open(spill_queue_t* sq, spill_segment_t* seg, uint32_t index, bool create) {
+    char path[SPILL_PATH_MAX + 64];
+    segment_path(sq, index, path, sizeof(path));
+    
+    // O_EXCL: never truncate a file this queue did not create. The blocks
+    // are reserved up front; a sparse file would fault on a full disk.
+    int fd = create ? open(path, O_RDWR | O_CREAT | O_EXCL, 0600) : open(path, O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    if (create && posix_fallocate(fd, 0, sq->segment_size) != 0) {
+        close(fd);
+        unlink(path);
+        return false;
+    }
+    
+    void* map = mmap(NULL, sq->segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    
+    seg->map = map;
+    seg->index = index;
+    seg->fd = fd;
+    return true;
+}
+
+static void segment_close(spill_queue_t* sq, spill_segment_t* seg, bool remove) {
+    if (seg->map) {
+        munmap(seg->map, sq->segment_size);
+        close(seg->fd);
+        seg->map = NULL;
+    }
+    if (remove) {
+        char path[SPILL_PATH_MAX + 64];
+        segment_path(sq, seg->index, path, sizeof(path));
+        unlink(path);
+    }
+}
+
+static bool spill_append(spill_queue_t* sq, uint8_t item) {
+    if (!sq->write_seg.map) {
+        if (!segment_open(sq, &sq->write_seg, sq->write_seg.index, true)) {
+            return false;
+        }
+        sq->write_pos = 0;
+    }
+    
+    sq->write_seg.map[sq->write_pos++] = item;
+    sq->spilled++;
+    sq->spilled_total++;
+    
+    // A full segment is unmapped; its index moves on to the next file
+    if (sq->write_pos == sq->segment_size) {
+        segment_close(sq, &sq->write_seg, false);
+        sq->write_seg.index++;
+    }
+    return true;
+}
+
+// Moves up to one ring's worth of the oldest spilled items back into the
+// empty ring, a contiguous run at a time
+static void spill_refill(spill_queue_t* sq) {
+    while (sq->spilled > 0 && !queue_is_full(&sq->ring)) {
+        if (!sq->read_seg.map &&
+            !segment_open(sq, &sq->read_seg, sq->read_seg.index, false)) {
+            return;
+        }
+        
+        uint32_t available = sq->segment_size - sq->read_pos;
+        if (available > sq->spilled) {
+            available = (uint32_t)sq->spilled;
+        }
+        queue_span_t span = queue_reserve(&sq->ring, available);
+        memcpy(span.data, sq->read_seg.map + sq->read_pos, span.len);
+        queue_commit(&sq->ring, span.len);
+        sq->read_pos += span.len;
+        sq->spilled -= span.len;
+        
+        if (sq->read_pos == sq->segment_size) {
+            segment_close(sq, &sq->read_seg, true);
+            sq->read_seg.index++;
+            sq->read_pos = 0;
+        }
+    }
+}
+
+bool spill_queue_init(spill_queue_t* sq, uint32_t ring_size, const char* dir,
+                      uint32_t segment_size) {
+    if (!sq || !dir || ring_size == 0 || ring_size > QUEUE_MAX_SIZE ||
+        strlen(dir) >= SPILL_PATH_MAX) {
+        return false;
+    }
+    
+    memset(sq, 0, sizeof(*sq));
+    queue_init(&sq->ring, ring_size);
+    strcpy(sq->dir, dir);
+    snprintf(sq->tag, sizeof(sq->tag), "%ld-%u", (long)getpid(),
+             __atomic_fetch_add(&queue_counter, 1, __ATOMIC_RELAXED));
+    sq->segment_size = segment_size ? segment_size : SPILL_DEFAULT_SEGMENT_SIZE;
+    sq->write_seg.fd = -1;
+    sq->read_seg.fd = -1;
+    return true;
+}
+
+void spill_queue_destroy(spill_queue_t* sq) {
+    if (!sq) {
+        return;
+    }
+    
+    // Delete every segment file still holding unread items
+    uint32_t last = sq->write_seg.index;
+    segment_close(sq, &sq->write_seg, false);
+    segment_close(sq, &sq->read_seg, false);
+    for (uint32_t index = sq->read_seg.index; index <= last; index++) {
+        char path[SPILL_PATH_MAX + 64];
+        segment_path(sq, index, path, sizeof(path));
+        unlink(path);
+    }
+    queue_clear(&sq->ring);
+    sq->spilled = 0;
+}
+
+bool spill_queue_enqueue(spill_queue_t* sq, uint8_t item) {
+    if (!sq) {
+        return false;
+    }
+    
+    // Fast path: nothing on disk, so the ring still holds the newest items
+    if (sq->spilled == 0 && queue_enqueue(&sq->ring, item)) {
+        return true;
+    }
+    return spill_append(sq, item);
+}
+
+bool spill_queue_dequeue(spill_queue_t* sq, uint8_t* item) {
+    if (!sq || !item) {
+        return false;
+    }
+    
+    if (queue_is_empty(&sq->ring)) {
+        spill_refill(sq);
+    }
+    return queue_dequeue(&sq->ring, item);
+}
+
+uint64_t spill_queue_size(const spill_queue_t* sq) {
+    return sq ? queue_size(&sq->ring) + sq->spilled : 0;
+}
+
+uint64_t spill_queue_spilled(const spill_queue_t* sq) {
+    return sq ? sq->spilled : 0;
+}
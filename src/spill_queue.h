@@ -0,0 +1,51 @@
+#ifndef SPILL_QUEUE_H
+#define SPILL_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "queue.h"
+
+#define SPILL_PATH_MAX             256
+#define SPILL_DEFAULT_SEGMENT_SIZE (16u * 1024u * 1024u)
+
+typedef struct {
+    uint8_t* map;
+    uint32_t index;
+    int fd;
+} spill_segment_t;
+
+// queue_t with an overflow tier of memory-mapped segment files. While
+// nothing is spilled, enqueue/dequeue go straight to the in-memory ring.
+// Once the ring is full, items are appended to segment files in dir; every
+// later item follows them to disk until the backlog is drained, so FIFO
+// order holds. When the ring runs empty it is refilled from the oldest
+// segment in one bulk copy, and fully read segments are deleted. At most
+// two segments (write and read end) are mapped at any time.
+//
+// Segment blocks are reserved with posix_fallocate before use, so a full
+// disk makes enqueue return false instead of raising SIGBUS on a store.
+// Segment names carry a per-queue tag (pid and a counter), so several
+// queues, even in different processes, may share dir.
+typedef struct {
+    queue_t ring;
+    char dir[SPILL_PATH_MAX];
+    char tag[32];
+    uint32_t segment_size;
+    spill_segment_t write_seg;
+    uint32_t write_pos;
+    spill_segment_t read_seg;
+    uint32_t read_pos;
+    uint64_t spilled;
+    uint64_t spilled_total;
+} spill_queue_t;
+
+// Function declarations
+bool spill_queue_init(spill_queue_t* sq, uint32_t ring_size, const char* dir,
+                      uint32_t segment_size);
+void spill_queue_destroy(spill_queue_t* sq);
+bool spill_queue_enqueue(spill_queue_t* sq, uint8_t item);
+bool spill_queue_dequeue(spill_queue_t* sq, uint8_t* item);
+uint64_t spill_queue_size(const spill_queue_t* sq);
+uint64_t spill_queue_spilled(const spill_queue_t* sq);
+
+#endif // SPILL_QUEUE_H
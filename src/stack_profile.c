@@ -0,0 +1,78 @@
+#include "stack_profile.h"
+#include <string.h>
+
+#define SCAN_BLOCK 64u
+
+// Two 64-bit lanes; may_alias because stacks are written as other types
+typedef uint64_t stack_vec_t __attribute__((vector_size(16), may_alias));
+
+void stack_paint(void* stack, uint32_t size) {
+    if (stack) {
+        memset(stack, STACK_FILL_BYTE, size);
+    }
+}
+
+// Counts painted bytes from the low end of the stack. Whole cache lines
+// are checked four vectors at a time, folding the XORs against the fill
+// pattern into one test; the first line with a difference is then walked
+// word by word and byte by byte.
+uint32_t stack_unused_bytes(const void* stack, uint32_t size) {
+    if (!stack) {
+        return 0;
+    }
+    const uint8_t* start = stack;
+    const uint8_t* end = start + size;
+    const uint8_t* p = start;
+    
+    while (p < end && ((uintptr_t)p & (sizeof(stack_vec_t) - 1))) {
+        if (*p != STACK_FILL_BYTE) {
+            return (uint32_t)(p - start);
+        }
+        p++;
+    }
+    
+    const stack_vec_t fill = { STACK_FILL_WORD, STACK_FILL_WORD };
+    while ((uint32_t)(end - p) >= SCAN_BLOCK) {
+        const stack_vec_t* v = (const stack_vec_t*)p;
+        stack_vec_t diff = (v[0] ^ fill) | (v[1] ^ fill) | (v[2] ^ fill) | (v[3] ^ fill);
+        if (diff[0] | diff[1]) {
+            break;
+        }
+        p += SCAN_BLOCK;
+    }
+    
+    while ((uint32_t)(end - p) >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        if (word != STACK_FILL_WORD) {
+            break;
+        }
+        p += sizeof(word);
+    }
+    while (p < end && *p == STACK_FILL_BYTE) {
+        p++;
+    }
+    return (uint32_t)(p - start);
+}
+
+uint32_t stack_recommend_size(uint32_t used) {
+    uint64_t margin = (uint64_t)used * STACK_MARGIN_PERCENT / 100u;
+    if (margin < STACK_MARGIN_MIN) {
+        margin = STACK_MARGIN_MIN;
+    }
+    uint64_t size = ((uint64_t)used + margin + STACK_ALIGN - 1) & ~(uint64_t)(STACK_ALIGN - 1);
+    if (size < STACK_MIN_SIZE) {
+        size = STACK_MIN_SIZE;
+    }
+    return size > UINT32_MAX ? UINT32_MAX : (uint32_t)size;
+}
+
+bool stack_canary_intact(const void* stack) {
+    const uint8_t* p = stack;
+    for (uint32_t i = 0; i < STACK_CANARY_SIZE; i++) {
+        if (p[i] != STACK_FILL_BYTE) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef STACK_PROFILE_H
+#define STACK_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Stack painting, as FreeRTOS does for uxTaskGetStackHighWaterMark: a stack
+// is filled with a known byte when its task is created. Stacks grow down,
+// so the painted bytes still intact at the low (far) end were never
+// touched, and their count is the high-water mark: the least free space
+// the task has ever had.
+
+#define STACK_FILL_BYTE 0xA5u
+#define STACK_FILL_WORD 0xA5A5A5A5A5A5A5A5ull
+
+// Recommended size = peak use plus a margin of STACK_MARGIN_PERCENT, at
+// least STACK_MARGIN_MIN bytes, rounded up to STACK_ALIGN
+#define STACK_MARGIN_PERCENT 25u
+#define STACK_MARGIN_MIN     128u
+#define STACK_ALIGN          16u
+#define STACK_MIN_SIZE       1024u  // smallest stack a green thread accepts
+
+// Painted bytes at the far end of a stack that must survive every switch
+// away from its green thread, as FreeRTOS configCHECK_FOR_STACK_OVERFLOW 2
+#define STACK_CANARY_SIZE    16u
+
+// Function declarations
+void stack_paint(void* stack, uint32_t size);
+uint32_t stack_unused_bytes(const void* stack, uint32_t size);
+uint32_t stack_recommend_size(uint32_t used);
+bool stack_canary_intact(const void* stack);
+
+#endif // STACK_PROFILE_H
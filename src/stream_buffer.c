@@ -0,0 +1,260 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "stream_buffer.h"
+#include "mem_pool.h"
+#include <string.h>
+
+typedef struct {
+    const stream_buffer_t* sb;
+    uint32_t needed;
+} wait_ctx_t;
+
+static bool enough_data(const void* ctx) {
+    const wait_ctx_t* wait = ctx;
+    return wait->sb->count >= wait->needed;
+}
+
+static bool enough_space(const void* ctx) {
+    const wait_ctx_t* wait = ctx;
+    return wait->sb->max_size - wait->sb->count >= wait->needed;
+}
+
+// Copies len bytes in at tail; the caller has checked the space. Only a
+// run that crosses the end of storage takes a second memcpy.
+static void ring_write(stream_buffer_t* sb, const uint8_t* data, uint32_t len) {
+    uint32_t first = sb->max_size - sb->tail;
+    if (first >= len) {
+        memcpy(&sb->storage[sb->tail], data, len);
+    } else {
+        memcpy(&sb->storage[sb->tail], data, first);
+        memcpy(sb->storage, data + first, len - first);
+    }
+    sb->tail = (sb->tail + len) % sb->max_size;
+    sb->count += len;
+}
+
+// Copies len bytes out from head without consuming them
+static void ring_peek(const stream_buffer_t* sb, uint8_t* data, uint32_t len) {
+    uint32_t first = sb->max_size - sb->head;
+    if (first >= len) {
+        memcpy(data, &sb->storage[sb->head], len);
+    } else {
+        memcpy(data, &sb->storage[sb->head], first);
+        memcpy(data + first, sb->storage, len - first);
+    }
+}
+
+static void ring_consume(stream_buffer_t* sb, uint32_t len) {
+    sb->head = (sb->head + len) % sb->max_size;
+    sb->count -= len;
+}
+
+// Senders wait for different amounts of space, so frees wake them all.
+// Wakes one receiver once the data it waits for is there. Stream readers
+// wait for trigger_level bytes; message readers for one whole message.
+static void notify_data(stream_buffer_t* sb) {
+    if (sb->count >= sb->trigger_level) {
+        pthread_cond_signal(&sb->data_ready);
+    }
+}
+
+static bool buffer_init(stream_buffer_t* sb, uint8_t* storage, uint32_t size,
+                        uint32_t trigger_level, bool is_message_buffer) {
+    if (!sb || !storage || size == 0 || trigger_level == 0 || trigger_level > size) {
+        return false;
+    }
+    
+    sb->storage = storage;
+    sb->head = 0;
+    sb->tail = 0;
+    sb->count = 0;
+    sb->max_size = size;
+    sb->trigger_level = trigger_level;
+    sb->is_message_buffer = is_message_buffer;
+    sb->owns_storage = false;
+    pthread_mutex_init(&sb->lock, NULL);
+    timeout_cond_init(&sb->data_ready);
+    timeout_cond_init(&sb->space_ready);
+    return true;
+}
+
+bool stream_buffer_init(stream_buffer_t* sb, uint8_t* storage, uint32_t size,
+                        uint32_t trigger_level) {
+    return buffer_init(sb, storage, size, trigger_level, false);
+}
+
+bool stream_buffer_create(stream_buffer_t* sb, uint32_t size, uint32_t trigger_level) {
+    if (!sb) {
+        return false;
+    }
+    uint8_t* storage = mem_pool_alloc(size);
+    if (!stream_buffer_init(sb, storage, size, trigger_level)) {
+        mem_pool_free(storage);
+        return false;
+    }
+    sb->owns_storage = true;
+    return true;
+}
+
+void stream_buffer_destroy(stream_buffer_t* sb) {
+    if (sb) {
+        if (sb->owns_storage) {
+            mem_pool_free(sb->storage);
+            sb->storage = NULL;
+            sb->owns_storage = false;
+        }
+        pthread_cond_destroy(&sb->data_ready);
+        pthread_cond_destroy(&sb->space_ready);
+        pthread_mutex_destroy(&sb->lock);
+    }
+}
+
+size_t stream_buffer_send(stream_buffer_t* sb, const void* data, size_t len,
+                          uint32_t timeout_ms) {
+    if (!sb || !data || sb->is_message_buffer || len == 0) {
+        return 0;
+    }
+    
+    // Wait for room for the whole write, then write whatever fits
+    pthread_mutex_lock(&sb->lock);
+    wait_ctx_t wait = { sb, len < sb->max_size ? (uint32_t)len : sb->max_size };
+    timeout_wait(&sb->space_ready, &sb->lock, timeout_ms, enough_space, &wait);
+    
+    uint32_t space = sb->max_size - sb->count;
+    uint32_t written = len < space ? (uint32_t)len : space;
+    if (written > 0) {
+        ring_write(sb, data, written);
+        notify_data(sb);
+    }
+    pthread_mutex_unlock(&sb->lock);
+    return written;
+}
+
+size_t stream_buffer_receive(stream_buffer_t* sb, void* data, size_t len,
+                             uint32_t timeout_ms) {
+    if (!sb || !data || sb->is_message_buffer || len == 0) {
+        return 0;
+    }
+    
+    // Wait for the trigger level, then return whatever is there
+    pthread_mutex_lock(&sb->lock);
+    wait_ctx_t wait = { sb, sb->trigger_level };
+    timeout_wait(&sb->data_ready, &sb->lock, timeout_ms, enough_data, &wait);
+    
+    uint32_t read = len < sb->count ? (uint32_t)len : sb->count;
+    if (read > 0) {
+        ring_peek(sb, data, read);
+        ring_consume(sb, read);
+        pthread_cond_broadcast(&sb->space_ready);
+    }
+    pthread_mutex_unlock(&sb->lock);
+    return read;
+}
+
+bool stream_buffer_set_trigger_level(stream_buffer_t* sb, uint32_t trigger_level) {
+    if (!sb || sb->is_message_buffer || trigger_level == 0 ||
+        trigger_level > sb->max_size) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&sb->lock);
+    sb->trigger_level = trigger_level;
+    notify_data(sb);
+    pthread_mutex_unlock(&sb->lock);
+    return true;
+}
+
+uint32_t stream_buffer_bytes_available(stream_buffer_t* sb) {
+    if (!sb) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&sb->lock);
+    uint32_t count = sb->count;
+    pthread_mutex_unlock(&sb->lock);
+    return count;
+}
+
+uint32_t stream_buffer_spaces_available(stream_buffer_t* sb) {
+    if (!sb) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&sb->lock);
+    uint32_t space = sb->max_size - sb->count;
+    pthread_mutex_unlock(&sb->lock);
+    return space;
+}
+
+bool message_buffer_init(message_buffer_t* mb, uint8_t* storage, uint32_t size) {
+    if (size <= MESSAGE_BUFFER_LENGTH_BYTES) {
+        return false;
+    }
+    // The smallest record is a length prefix with an empty payload
+    return buffer_init(mb, storage, size, MESSAGE_BUFFER_LENGTH_BYTES, true);
+}
+
+bool message_buffer_create(message_buffer_t* mb, uint32_t size) {
+    if (!mb) {
+        return false;
+    }
+    uint8_t* storage = mem_pool_alloc(size);
+    if (!message_buffer_init(mb, storage, size)) {
+        mem_pool_free(storage);
+        return false;
+    }
+    mb->owns_storage = true;
+    return true;
+}
+
+void message_buffer_destroy(message_buffer_t* mb) {
+    stream_buffer_destroy(mb);
+}
+
+size_t message_buffer_send(message_buffer_t* mb, const void* data, size_t len,
+                           uint32_t timeout_ms) {
+    if (!mb || !data || !mb->is_message_buffer ||
+        len > mb->max_size - MESSAGE_BUFFER_LENGTH_BYTES) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&mb->lock);
+    wait_ctx_t wait = { mb, (uint32_t)(len + MESSAGE_BUFFER_LENGTH_BYTES) };
+    bool sent = timeout_wait(&mb->space_ready, &mb->lock, timeout_ms, enough_space, &wait);
+    if (sent) {
+        // Prefix and payload are one contiguous record, so the wrap point
+        // splits at most one of them: three memcpy at most
+        uint32_t length = (uint32_t)len;
+        ring_write(mb, (const uint8_t*)&length, MESSAGE_BUFFER_LENGTH_BYTES);
+        ring_write(mb, data, length);
+        notify_data(mb);
+    }
+    pthread_mutex_unlock(&mb->lock);
+    return sent ? len : 0;
+}
+
+size_t message_buffer_receive(message_buffer_t* mb, void* data, size_t len,
+                              uint32_t timeout_ms) {
+    if (!mb || !data || !mb->is_message_buffer) {
+        return 0;
+    }
+    
+    pthread_mutex_lock(&mb->lock);
+    wait_ctx_t wait = { mb, MESSAGE_BUFFER_LENGTH_BYTES };
+    size_t received = 0;
+    if (timeout_wait(&mb->data_ready, &mb->lock, timeout_ms, enough_data, &wait)) {
+        uint32_t length;
+        ring_peek(mb, (uint8_t*)&length, MESSAGE_BUFFER_LENGTH_BYTES);
+        
+        // A message that does not fit stays in the buffer
+        if (length <= len) {
+            ring_consume(mb, MESSAGE_BUFFER_LENGTH_BYTES);
+            ring_peek(mb, data, length);
+            ring_consume(mb, length);
+            pthread_cond_broadcast(&mb->space_ready);
+            received = length;
+        }
+    }
+    pthread_mutex_unlock(&mb->lock);
+    return received;
+}
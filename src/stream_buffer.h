@@ -0,0 +1,61 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "timeout.h"
+
+// Bytes of length prefix stored in front of every message buffer record
+#define MESSAGE_BUFFER_LENGTH_BYTES sizeof(uint32_t)
+
+// Byte ring in the style of FreeRTOS StreamBuffer/MessageBuffer, over
+// caller-provided storage. Data is moved with at most two memcpy calls per
+// operation (one either side of the wrap point).
+//
+// Stream buffers carry a byte stream; receivers are only woken once at
+// least trigger_level bytes are available. Message buffers store each
+// message as a length prefix plus payload and always send and receive
+// whole messages; receivers are woken per message.
+//
+// The *_create variants take their storage from the fixed-block pool
+// (up to MEM_POOL_MAX_BLOCK bytes) and give it back on destroy.
+typedef struct {
+    uint8_t* storage;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+    uint32_t max_size;
+    uint32_t trigger_level;
+    bool is_message_buffer;
+    bool owns_storage;
+    pthread_mutex_t lock;
+    pthread_cond_t data_ready;
+    pthread_cond_t space_ready;
+} stream_buffer_t;
+
+typedef stream_buffer_t message_buffer_t;
+
+// Function declarations
+bool stream_buffer_init(stream_buffer_t* sb, uint8_t* storage, uint32_t size,
+                        uint32_t trigger_level);
+bool stream_buffer_create(stream_buffer_t* sb, uint32_t size, uint32_t trigger_level);
+void stream_buffer_destroy(stream_buffer_t* sb);
+size_t stream_buffer_send(stream_buffer_t* sb, const void* data, size_t len,
+                          uint32_t timeout_ms);
+size_t stream_buffer_receive(stream_buffer_t* sb, void* data, size_t len,
+                             uint32_t timeout_ms);
+bool stream_buffer_set_trigger_level(stream_buffer_t* sb, uint32_t trigger_level);
+uint32_t stream_buffer_bytes_available(stream_buffer_t* sb);
+uint32_t stream_buffer_spaces_available(stream_buffer_t* sb);
+
+bool message_buffer_init(message_buffer_t* mb, uint8_t* storage, uint32_t size);
+bool message_buffer_create(message_buffer_t* mb, uint32_t size);
+void message_buffer_destroy(message_buffer_t* mb);
+size_t message_buffer_send(message_buffer_t* mb, const void* data, size_t len,
+                           uint32_t timeout_ms);
+size_t message_buffer_receive(message_buffer_t* mb, void* data, size_t len,
+                              uint32_t timeout_ms);
+
+#endif // STREAM_BUFFER_H
@@ -0,0 +1,62 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "green_thread.h"
+
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+
+#define tskSTATICALLY_ALLOCATED_STACK_AND_TCB     ((uint8_t)2)
+#define tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE 0
+
+// Task ids handed to the task manager for FreeRTOS-created tasks start
+// here, clear of ids chosen by callers of task_create
+#define FREERTOS_TASK_ID_BASE 0x10000u
+
+typedef void (*TaskFunction_t)(void* pvParameters);
+
+// Task control block. FreeRTOS keeps this private; the host shim exposes
+// it so tests can inspect what xTaskCreateStatic stored. Tasks run as green
+// threads on the StackType_t buffer passed to xTaskCreateStatic, which must
+// hold at least GREEN_MIN_STACK bytes.
+typedef struct tskTaskControlBlock {
+    StackType_t* pxTopOfStack;
+    StackType_t* pxStack;
+    char pcTaskName[configMAX_TASK_NAME_LEN];
+    UBaseType_t uxPriority;
+    UBaseType_t uxBasePriority;
+    UBaseType_t uxMutexesHeld;
+    uint8_t ucStaticallyAllocated;
+    
+    // Host shim state
+    uint32_t task_id;
+    uint32_t stack_depth;
+    TaskFunction_t task_code;
+    void* parameters;
+    bool spawned;
+    green_task_t green;
+} TCB_t;
+
+typedef TCB_t* TaskHandle_t;
+
+#define taskYIELD() vPortYield()
+
+// Function declarations
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char* pcName,
+                               uint32_t ulStackDepth, void* pvParameters,
+                               UBaseType_t uxPriority, StackType_t* puxStackBuffer,
+                               StaticTask_t* pxTaskBuffer);
+void vTaskDelete(TaskHandle_t xTask);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask);
+UBaseType_t uxTaskGetNumberOfTasks(void);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char* pcTaskGetName(TaskHandle_t xTask);
+void vTaskDelay(TickType_t xTicksToDelay);
+TickType_t xTaskGetTickCount(void);
+void vPortYield(void);
+void vTaskStartScheduler(void);
+void vTaskEndScheduler(void);
+
+#endif // TASK_H
@@ -1,70 +1,526 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "task_manager.h"
+#include "id_index.h"
+#include "mailbox.h"
+#include "mem_pool.h"
+#include "stack_profile.h"
+#include "sched_latency.h"
+#include "timestamp.h"
+#include "trace.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+// The default capacity lives in static storage; task_manager_init_capacity
+// moves larger tables to the heap
+static task_t default_tasks[MAX_TASKS];
+static uint32_t default_index_keys[TASK_INDEX_MIN_SIZE];
+static uint32_t default_index_slots[TASK_INDEX_MIN_SIZE];
 
-static task_t tasks[MAX_TASKS];
+static task_t* tasks = default_tasks;
+static uint32_t task_capacity = MAX_TASKS;
 static uint32_t task_count = 0;
 
+// State transitions since task_manager_init, deleted tasks included
+static uint64_t transitions_total = 0;
+
+// task_id -> tasks[] position
+static id_index_t task_index = { default_index_keys, default_index_slots, TASK_INDEX_MIN_SIZE - 1 };
+
+// The static default index starts zeroed, which reads as every slot taken;
+// it is cleared on first use so the API works without task_manager_init
+static bool index_ready = false;
+
+// Blocking queue waiters update task state from their own threads
+static pthread_mutex_t task_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Odd while tasks[] is being restructured (create, delete, resize), so
+// task_get_runtime_stats_all can read it without taking task_lock
+static uint32_t table_seq = 0;
+
+static __thread bool current_valid = false;
+static __thread uint32_t current_id = 0;
+static __thread uint32_t current_priority = 0;
+
+static uint32_t index_probe(uint32_t id) {
+    if (!index_ready) {
+        timestamp_init();
+        id_index_clear(&task_index);
+        index_ready = true;
+    }
+    return id_index_probe(&task_index, id);
+}
+
+// Writers hold task_lock, so there is only ever one
+static void table_write_begin(void) {
+    __atomic_store_n(&table_seq, table_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void table_write_end(void) {
+    __atomic_store_n(&table_seq, table_seq + 1, __ATOMIC_RELEASE);
+}
+
+static task_t* task_find(uint32_t id) {
+    uint32_t pos = index_probe(id);
+    if (pos == ID_INDEX_NONE || task_index.slots[pos] == ID_INDEX_FREE) {
+        return NULL;
+    }
+    return &tasks[task_index.slots[pos]];
+}
+
+// Sizes above MEM_POOL_MAX_BLOCK, or an exhausted class, go to the heap
+static void* stack_alloc(uint32_t stack_size) {
+    void* stack = mem_pool_alloc(stack_size);
+    return stack ? stack : malloc(stack_size);
+}
+
+static void stack_free(void* stack) {
+    if (mem_pool_owns(stack)) {
+        mem_pool_free(stack);
+    } else {
+        free(stack);
+    }
+}
+
+static void release_stack(task_t* task) {
+    if (task->owns_stack) {
+        stack_free(task->stack);
+    }
+}
+
 void task_manager_init(void) {
-    memset(tasks, 0, sizeof(tasks));
-    task_count = 0;
+    task_manager_init_capacity(MAX_TASKS);
 }
 
-bool task_create(uint32_t id, const char* name, uint32_t priority, uint32_t stack_size) {
-    if (task_count >= MAX_TASKS || !name) {
+bool task_manager_init_capacity(uint32_t capacity) {
+    if (capacity == 0) {
         return false;
     }
     
-    // Check if task ID already exists
-    for (uint32_t i = 0; i < task_count; i++) {
-        if (tasks[i].task_id == id) {
+    uint32_t index_size = TASK_INDEX_MIN_SIZE;
+    while (index_size < 2 * capacity) {
+        index_size <<= 1;
+    }
+    task_t* new_tasks = default_tasks;
+    uint32_t* new_keys = default_index_keys;
+    uint32_t* new_slots = default_index_slots;
+    if (capacity > MAX_TASKS || index_size > TASK_INDEX_MIN_SIZE) {
+        new_tasks = calloc(capacity, sizeof(task_t));
+        new_keys = malloc(index_size * sizeof(uint32_t));
+        new_slots = malloc(index_size * sizeof(uint32_t));
+        if (!new_tasks || !new_keys || !new_slots) {
+            free(new_tasks);
+            free(new_keys);
+            free(new_slots);
             return false;
         }
     }
     
-    tasks[task_count].task_id = id;
-    strncpy(tasks[task_count].name, name, TASK_NAME_LEN - 1);
-    tasks[task_count].name[TASK_NAME_LEN - 1] = '\0';
-    tasks[task_count].state = TASK_READY;
-    tasks[task_count].priority = priority;
-    tasks[task_count].stack_size = stack_size;
+    // Every task can hold a mailbox at once; they are allocated on demand
+    if (!mailbox_init_capacity(capacity)) {
+        if (new_tasks != default_tasks) {
+            free(new_tasks);
+            free(new_keys);
+            free(new_slots);
+        }
+        return false;
+    }
     
+    timestamp_init();
+    pthread_mutex_lock(&task_lock);
+    table_write_begin();
+    for (uint32_t i = 0; i < task_count; i++) {
+        release_stack(&tasks[i]);
+    }
+    if (tasks != default_tasks) {
+        free(tasks);
+        free(task_index.keys);
+        free(task_index.slots);
+    }
+    if (new_tasks == default_tasks) {
+        memset(default_tasks, 0, sizeof(default_tasks));
+    }
+    tasks = new_tasks;
+    task_index.keys = new_keys;
+    task_index.slots = new_slots;
+    task_index.mask = index_size - 1;
+    id_index_clear(&task_index);
+    index_ready = true;
+    task_capacity = capacity;
+    task_count = 0;
+    __atomic_store_n(&transitions_total, 0, __ATOMIC_RELAXED);
+    table_write_end();
+    pthread_mutex_unlock(&task_lock);
+    sched_latency_reset();
+    return true;
+}
+
+// Whether task_add would take id now. Called with task_lock held.
+static bool task_slot_free(uint32_t id) {
+    uint32_t pos = index_probe(id);
+    return task_count < task_capacity && pos != ID_INDEX_NONE && task_index.slots[pos] == ID_INDEX_FREE;
+}
+
+// Inserts a task whose stack, if any, is ready and painted. Called with
+// task_lock held.
+static bool task_add(uint32_t id, const char* name, uint32_t priority,
+                     void* stack, uint32_t stack_size, bool owns_stack) {
+    uint32_t pos = index_probe(id);
+    // Check capacity and whether the task ID already exists
+    if (task_count >= task_capacity || pos == ID_INDEX_NONE || task_index.slots[pos] != ID_INDEX_FREE) {
+        return false;
+    }
+    
+    table_write_begin();
+    task_t* task = &tasks[task_count];
+    memset(task, 0, sizeof(*task));
+    task->task_id = id;
+    strncpy(task->name, name, TASK_NAME_LEN - 1);
+    task->name[TASK_NAME_LEN - 1] = '\0';
+    task->state = TASK_READY;
+    task->priority = priority;
+    task->stack_size = stack_size;
+    task->stack = stack;
+    task->owns_stack = owns_stack;
+    task->state_since = timestamp_now_ticks();
+    task->ready_since = task->state_since;
+    
+    task_index.keys[pos] = id;
+    task_index.slots[pos] = task_count;
     task_count++;
+    table_write_end();
+    TRACE_EVENT(TRACE_TASK_CREATE, id, priority);
     return true;
 }
 
-bool task_delete(uint32_t id) {
-    for (uint32_t i = 0; i < task_count; i++) {
-        if (tasks[i].task_id == id) {
-            // Shift remaining tasks
-            for (uint32_t j = i; j < task_count - 1; j++) {
-                tasks[j] = tasks[j + 1];
-            }
-            task_count--;
-            return true;
+// Allocating and painting a stack can take a while for large sizes, so it
+// happens outside task_lock, after a check that the create can succeed
+static bool task_create_with(uint32_t id, const char* name, uint32_t priority,
+                             void* stack, uint32_t stack_size) {
+    if (!name || stack_size > TASK_STACK_MAX_SIZE) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&task_lock);
+    bool ok = task_slot_free(id);
+    pthread_mutex_unlock(&task_lock);
+    if (!ok) {
+        return false;
+    }
+    
+    bool owns_stack = !stack && stack_size > 0;
+    if (owns_stack) {
+        stack = stack_alloc(stack_size);
+        if (!stack) {
+            return false;
         }
     }
-    return false;
+    // Painted so task_get_stack_high_water_mark can see how deep it got
+    stack_paint(stack, stack_size);
+    
+    // A racing create may have taken the id or the last slot meanwhile
+    pthread_mutex_lock(&task_lock);
+    ok = task_add(id, name, priority, stack, stack_size, owns_stack);
+    pthread_mutex_unlock(&task_lock);
+    if (!ok && owns_stack) {
+        stack_free(stack);
+    }
+    return ok;
+}
+
+// Stacks come from the fixed-block pool, so creating and deleting tasks
+// does not touch the heap while the pool has a block of the right size
+bool task_create(uint32_t id, const char* name, uint32_t priority, uint32_t stack_size) {
+    return task_create_with(id, name, priority, NULL, stack_size);
+}
+
+// Same as task_create, with a stack owned by the caller
+bool task_create_static(uint32_t id, const char* name, uint32_t priority,
+                        void* stack, uint32_t stack_size) {
+    if (!stack || stack_size == 0) {
+        return false;
+    }
+    return task_create_with(id, name, priority, stack, stack_size);
+}
+
+bool task_delete(uint32_t id) {
+    pthread_mutex_lock(&task_lock);
+    uint32_t pos = index_probe(id);
+    if (pos == ID_INDEX_NONE || task_index.slots[pos] == ID_INDEX_FREE) {
+        pthread_mutex_unlock(&task_lock);
+        return false;
+    }
+    
+    uint32_t slot = task_index.slots[pos];
+    void* stack = tasks[slot].owns_stack ? tasks[slot].stack : NULL;
+    id_index_remove(&task_index, pos);
+    
+    // Move the last task into the hole and repoint its index entry
+    table_write_begin();
+    task_count--;
+    if (slot != task_count) {
+        tasks[slot] = tasks[task_count];
+        task_index.slots[index_probe(tasks[slot].task_id)] = slot;
+    }
+    table_write_end();
+    TRACE_EVENT(TRACE_TASK_DELETE, id, 0);
+    pthread_mutex_unlock(&task_lock);
+    if (stack) {
+        stack_free(stack);
+    }
+    mailbox_release(id);
+    return true;
 }
 
 task_t* task_get(uint32_t id) {
-    for (uint32_t i = 0; i < task_count; i++) {
-        if (tasks[i].task_id == id) {
-            return &tasks[i];
+    pthread_mutex_lock(&task_lock);
+    task_t* task = task_find(id);
+    pthread_mutex_unlock(&task_lock);
+    return task;
+}
+
+// Charges the time since the last change to the state being left. Stores
+// are relaxed atomics: task_lock orders writers, and lock-free readers
+// only need untorn values.
+static void stats_account(task_t* task, task_state_t state) {
+    uint64_t now = timestamp_now_ticks();
+    uint64_t* spent = &task->time_in_state[task->state];
+    __atomic_store_n(spent, *spent + (now - task->state_since), __ATOMIC_RELAXED);
+    __atomic_store_n(&task->state_since, now, __ATOMIC_RELAXED);
+    if (state != task->state) {
+        __atomic_store_n(&task->transitions, task->transitions + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&transitions_total, transitions_total + 1, __ATOMIC_RELAXED);
+        if (state == TASK_RUNNING) {
+            __atomic_store_n(&task->last_run, now, __ATOMIC_RELAXED);
+        } else if (state == TASK_READY) {
+            task->ready_since = now;
         }
     }
-    return NULL;
+    __atomic_store_n(&task->state, state, __ATOMIC_RELAXED);
 }
 
-bool task_set_state(uint32_t id, task_state_t state) {
-    task_t* task = task_get(id);
-    if (task) {
-        task->state = state;
-        return true;
+// Sets the state, or with expected non-NULL only while the task is in
+// *expected. False if the task is unknown or not in *expected.
+static bool set_state(uint32_t id, const task_state_t* expected, task_state_t state) {
+    bool alarm = false;
+    bool changed = false;
+    uint32_t priority = 0;
+    uint64_t latency_ns = 0;
+    
+    // The state indexes time_in_state
+    if ((uint32_t)state >= TASK_STATE_COUNT) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&task_lock);
+    task_t* task = task_find(id);
+    if (task && (!expected || task->state == *expected)) {
+        bool woken = task->state == TASK_READY && state == TASK_RUNNING;
+        stats_account(task, state);
+        if (woken) {
+            priority = task->priority;
+            latency_ns = timestamp_ticks_to_ns(task->state_since - task->ready_since);
+            alarm = sched_latency_record(priority, latency_ns);
+        }
+        TRACE_EVENT(TRACE_TASK_STATE, id, state);
+        changed = true;
     }
-    return false;
+    pthread_mutex_unlock(&task_lock);
+    
+    // The alarm callback may call back into the task manager
+    if (alarm) {
+        sched_latency_alarm(id, priority, latency_ns);
+    }
+    return changed;
+}
+
+bool task_set_state(uint32_t id, task_state_t state) {
+    return set_state(id, NULL, state);
+}
+
+// Compare-and-set: changes the state only if the task is still in expected,
+// so a change made by another thread in between is not overwritten
+bool task_set_state_if(uint32_t id, task_state_t expected, task_state_t state) {
+    return set_state(id, &expected, state);
 }
 
 uint32_t task_get_count(void) {
     return task_count;
+}
+
+uint32_t task_get_capacity(void) {
+    return task_capacity;
+}
+
+// Least free stack space the task has had since creation, in bytes.
+// 0 for unknown tasks and tasks without a stack.
+uint32_t task_get_stack_high_water_mark(uint32_t id) {
+    pthread_mutex_lock(&task_lock);
+    task_t* task = task_find(id);
+    uint32_t unused = task ? stack_unused_bytes(task->stack, task->stack_size) : 0;
+    pthread_mutex_unlock(&task_lock);
+    return unused;
+}
+
+// Fills up to max_reports entries, one per task with a stack, with its
+// peak stack use and a right-sized stack for it. Returns the number filled.
+uint32_t task_stack_report(task_stack_report_t* reports, uint32_t max_reports) {
+    if (!reports) {
+        return 0;
+    }
+    
+    uint32_t count = 0;
+    pthread_mutex_lock(&task_lock);
+    for (uint32_t i = 0; i < task_count && count < max_reports; i++) {
+        task_t* task = &tasks[i];
+        if (!task->stack) {
+            continue;
+        }
+        task_stack_report_t* report = &reports[count++];
+        report->task_id = task->task_id;
+        memcpy(report->name, task->name, TASK_NAME_LEN);
+        report->stack_size = task->stack_size;
+        report->peak_used = task->stack_size - stack_unused_bytes(task->stack, task->stack_size);
+        report->recommended = stack_recommend_size(report->peak_used);
+    }
+    pthread_mutex_unlock(&task_lock);
+    return count;
+}
+
+static void stats_fill(const task_t* task, uint64_t now_ticks, uint64_t now_ns,
+                       task_runtime_stats_t* stats) {
+    stats->task_id = __atomic_load_n(&task->task_id, __ATOMIC_RELAXED);
+    memcpy(stats->name, task->name, TASK_NAME_LEN);
+    stats->name[TASK_NAME_LEN - 1] = '\0';
+    stats->state = __atomic_load_n(&task->state, __ATOMIC_RELAXED);
+    
+    uint64_t since = __atomic_load_n(&task->state_since, __ATOMIC_RELAXED);
+    for (uint32_t s = 0; s < TASK_STATE_COUNT; s++) {
+        uint64_t ticks = __atomic_load_n(&task->time_in_state[s], __ATOMIC_RELAXED);
+        if (s == (uint32_t)stats->state && now_ticks > since) {
+            ticks += now_ticks - since;
+        }
+        stats->time_in_state_ns[s] = timestamp_ticks_to_ns(ticks);
+    }
+    stats->transitions = __atomic_load_n(&task->transitions, __ATOMIC_RELAXED);
+    
+    uint64_t last_run = __atomic_load_n(&task->last_run, __ATOMIC_RELAXED);
+    stats->last_run_ns = 0;
+    if (last_run != 0) {
+        uint64_t ago = now_ticks > last_run ? timestamp_ticks_to_ns(now_ticks - last_run) : 0;
+        stats->last_run_ns = now_ns > ago ? now_ns - ago : 0;
+    }
+}
+
+bool task_get_runtime_stats(uint32_t id, task_runtime_stats_t* stats) {
+    if (!stats) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&task_lock);
+    task_t* task = task_find(id);
+    if (task) {
+        stats_fill(task, timestamp_now_ticks(), timestamp_now_ns(), stats);
+    }
+    pthread_mutex_unlock(&task_lock);
+    return task != NULL;
+}
+
+// Copies the statistics of up to max_stats tasks without taking task_lock,
+// so tasks keep changing state while the dump runs. The copy is retried
+// if tasks are created or deleted meanwhile. Returns the number copied.
+// Must not run concurrently with task_manager_init_capacity.
+uint32_t task_get_runtime_stats_all(task_runtime_stats_t* stats, uint32_t max_stats) {
+    if (!stats) {
+        return 0;
+    }
+    
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&table_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            sched_yield();
+            continue;
+        }
+    
+        const task_t* table = __atomic_load_n(&tasks, __ATOMIC_RELAXED);
+        uint32_t count = __atomic_load_n(&task_count, __ATOMIC_RELAXED);
+        if (count > max_stats) {
+            count = max_stats;
+        }
+        uint64_t now_ticks = timestamp_now_ticks();
+        uint64_t now_ns = timestamp_now_ns();
+        for (uint32_t i = 0; i < count; i++) {
+            stats_fill(&table[i], now_ticks, now_ns, &stats[i]);
+        }
+    
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&table_seq, __ATOMIC_RELAXED) == seq) {
+            return count;
+        }
+    }
+}
+
+// Counts tasks per state without taking task_lock, retrying like
+// task_get_runtime_stats_all if tasks are created or deleted meanwhile
+bool task_get_state_counts(task_state_counts_t* counts) {
+    if (!counts) {
+        return false;
+    }
+    
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&table_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            sched_yield();
+            continue;
+        }
+    
+        memset(counts, 0, sizeof(*counts));
+        const task_t* table = __atomic_load_n(&tasks, __ATOMIC_RELAXED);
+        counts->count = __atomic_load_n(&task_count, __ATOMIC_RELAXED);
+        counts->capacity = __atomic_load_n(&task_capacity, __ATOMIC_RELAXED);
+        for (uint32_t i = 0; i < counts->count; i++) {
+            task_state_t state = __atomic_load_n(&table[i].state, __ATOMIC_RELAXED);
+            if ((uint32_t)state < TASK_STATE_COUNT) {
+                counts->per_state[state]++;
+            }
+        }
+        counts->transitions = __atomic_load_n(&transitions_total, __ATOMIC_RELAXED);
+    
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&table_seq, __ATOMIC_RELAXED) == seq) {
+            return true;
+        }
+    }
+}
+
+void task_set_current(uint32_t id) {
+    pthread_mutex_lock(&task_lock);
+    task_t* task = task_find(id);
+    current_priority = task ? task->priority : 0;
+    pthread_mutex_unlock(&task_lock);
+    
+    current_id = id;
+    current_valid = true;
+}
+
+void task_clear_current(void) {
+    current_valid = false;
+}
+
+bool task_get_current(uint32_t* id) {
+    if (!id || !current_valid) {
+        return false;
+    }
+    *id = current_id;
+    return true;
+}
+
+// Priority cached by task_set_current(). Reads only thread-local state, so
+// it is safe to call from a signal handler.
+uint32_t task_get_current_priority(void) {
+    return current_valid ? current_priority : 0;
 }
\ No newline at end of file
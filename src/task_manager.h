@@ -4,8 +4,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define MAX_TASKS 10
+#define MAX_TASKS 10             // default capacity, see task_manager_init_capacity
+#define TASK_INDEX_MIN_SIZE 32   // power of two, at least 2 * MAX_TASKS
 #define TASK_NAME_LEN 16
+#define TASK_STACK_MAX_SIZE (8u * 1024u * 1024u)   // largest stack a task may have
 
 typedef enum {
     TASK_READY,
@@ -14,20 +16,75 @@ typedef enum {
     TASK_SUSPENDED
 } task_state_t;
 
+#define TASK_STATE_COUNT (TASK_SUSPENDED + 1)
+
 typedef struct {
     uint32_t task_id;
     char name[TASK_NAME_LEN];
     task_state_t state;
     uint32_t priority;
     uint32_t stack_size;
+    void* stack;
+    bool owns_stack;
+    
+    // Runtime statistics kept by task_set_state, in timestamp ticks
+    uint64_t state_since;
+    uint64_t time_in_state[TASK_STATE_COUNT];
+    uint64_t last_run;       // when the task last became RUNNING, 0 if never
+    uint64_t ready_since;    // when the task last became READY, see sched_latency.h
+    uint64_t transitions;
 } task_t;
 
+// Stack use of one task, see task_stack_report
+typedef struct {
+    uint32_t task_id;
+    char name[TASK_NAME_LEN];
+    uint32_t stack_size;
+    uint32_t peak_used;      // bytes touched since creation
+    uint32_t recommended;    // peak_used plus a safety margin
+} task_stack_report_t;
+
+// Runtime statistics of one task, like FreeRTOS vTaskGetRunTimeStats.
+// Times include the interval the task is currently in.
+typedef struct {
+    uint32_t task_id;
+    char name[TASK_NAME_LEN];
+    task_state_t state;
+    uint64_t time_in_state_ns[TASK_STATE_COUNT];
+    uint64_t transitions;
+    uint64_t last_run_ns;    // timestamp_now_ns() time, 0 if never run
+} task_runtime_stats_t;
+
+// Task totals, see task_get_state_counts
+typedef struct {
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t per_state[TASK_STATE_COUNT];
+    uint64_t transitions;    // since task_manager_init, monotonic
+} task_state_counts_t;
+
 // Function declarations
 bool task_create(uint32_t id, const char* name, uint32_t priority, uint32_t stack_size);
+bool task_create_static(uint32_t id, const char* name, uint32_t priority,
+                        void* stack, uint32_t stack_size);
 bool task_delete(uint32_t id);
 task_t* task_get(uint32_t id);
 bool task_set_state(uint32_t id, task_state_t state);
+bool task_set_state_if(uint32_t id, task_state_t expected, task_state_t state);
 uint32_t task_get_count(void);
+uint32_t task_get_capacity(void);
+uint32_t task_get_stack_high_water_mark(uint32_t id);
+uint32_t task_stack_report(task_stack_report_t* reports, uint32_t max_reports);
+bool task_get_runtime_stats(uint32_t id, task_runtime_stats_t* stats);
+uint32_t task_get_runtime_stats_all(task_runtime_stats_t* stats, uint32_t max_stats);
+bool task_get_state_counts(task_state_counts_t* counts);
 void task_manager_init(void);
+bool task_manager_init_capacity(uint32_t capacity);
+
+// Task bound to the calling thread, used by blocking APIs to report state
+void task_set_current(uint32_t id);
+void task_clear_current(void);
+bool task_get_current(uint32_t* id);
+uint32_t task_get_current_priority(void);
 
 #endif // TASK_MANAGER_H
\ No newline at end of file
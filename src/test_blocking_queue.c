@@ -0,0 +1,184 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include "blocking_queue.h"
+#include "task_manager.h"
+
+static blocking_queue_t bq;
+static volatile bool consumer_done = false;
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void* consumer_task(void* arg) {
+    (void)arg;
+    uint8_t item;
+    
+    task_set_current(7);
+    task_set_state(7, TASK_RUNNING);
+    bool ok = blocking_queue_receive(&bq, &item, QUEUE_WAIT_FOREVER);
+    assert(ok && item == 42);
+    consumer_done = true;
+    return NULL;
+}
+
+// Test cases
+void test_blocking_queue_timeout(void) {
+    uint8_t item;
+    struct timespec start, end;
+    
+    assert(blocking_queue_init(&bq, 2) == true);
+    assert(blocking_queue_receive(&bq, &item, QUEUE_NO_WAIT) == false);
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    assert(blocking_queue_receive(&bq, &item, 20) == false);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    long elapsed_ms = (end.tv_sec - start.tv_sec) * 1000 +
+                      (end.tv_nsec - start.tv_nsec) / 1000000;
+    assert(elapsed_ms >= 19);
+    
+    assert(blocking_queue_send(&bq, 1, QUEUE_NO_WAIT) == true);
+    assert(blocking_queue_send(&bq, 2, QUEUE_NO_WAIT) == true);
+    assert(blocking_queue_send(&bq, 3, 10) == false);
+    assert(blocking_queue_size(&bq) == 2);
+    
+    blocking_queue_destroy(&bq);
+    printf("✓ test_blocking_queue_timeout passed\n");
+}
+
+void test_blocking_queue_marks_task_blocked(void) {
+    pthread_t thread;
+    
+    task_manager_init();
+    task_create(7, "Consumer", 3, 1024);
+    blocking_queue_init(&bq, 4);
+    
+    pthread_create(&thread, NULL, consumer_task, NULL);
+    for (int i = 0; i < 1000 && task_get(7)->state != TASK_BLOCKED; i++) {
+        sleep_ms(1);
+    }
+    assert(task_get(7)->state == TASK_BLOCKED);
+    assert(!consumer_done);
+    
+    assert(blocking_queue_send(&bq, 42, QUEUE_WAIT_FOREVER) == true);
+    pthread_join(thread, NULL);
+    assert(consumer_done);
+    assert(task_get(7)->state == TASK_RUNNING);
+    
+    blocking_queue_destroy(&bq);
+    printf("✓ test_blocking_queue_marks_task_blocked passed\n");
+}
+
+// A task suspended while it waits stays suspended once the wait ends
+void test_blocking_queue_keeps_suspended_state(void) {
+    pthread_t thread;
+    
+    task_manager_init();
+    task_create(7, "Consumer", 3, 1024);
+    blocking_queue_init(&bq, 4);
+    consumer_done = false;
+    
+    pthread_create(&thread, NULL, consumer_task, NULL);
+    for (int i = 0; i < 1000 && task_get(7)->state != TASK_BLOCKED; i++) {
+        sleep_ms(1);
+    }
+    assert(task_set_state_if(7, TASK_RUNNING, TASK_READY) == false);
+    assert(task_set_state_if(7, TASK_BLOCKED, TASK_SUSPENDED) == true);
+    assert(task_set_state_if(99, TASK_SUSPENDED, TASK_READY) == false);
+    
+    assert(blocking_queue_send(&bq, 42, QUEUE_WAIT_FOREVER) == true);
+    pthread_join(thread, NULL);
+    assert(consumer_done);
+    assert(task_get(7)->state == TASK_SUSPENDED);
+    
+    blocking_queue_destroy(&bq);
+    printf("✓ test_blocking_queue_keeps_suspended_state passed\n");
+}
+
+static void* burst_producer(void* arg) {
+    (void)arg;
+    for (uint8_t i = 0; i < 20; i++) {
+        blocking_queue_send(&bq, i, QUEUE_WAIT_FOREVER);
+    }
+    return NULL;
+}
+
+void test_blocking_queue_eventfd(void) {
+    struct epoll_event ev = { .events = EPOLLIN };
+    uint8_t items[8];
+    uint64_t value;
+    
+    blocking_queue_init(&bq, 32);
+    int fd = blocking_queue_event_fd(&bq);
+    assert(fd >= 0);
+    assert(blocking_queue_event_fd(&bq) == fd);
+    
+    int ep = epoll_create1(0);
+    epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+    assert(epoll_wait(ep, &ev, 1, 0) == 0);
+    
+    // Several sends coalesce into a single notification
+    for (uint8_t i = 0; i < 5; i++) {
+        blocking_queue_send(&bq, i, QUEUE_NO_WAIT);
+    }
+    assert(epoll_wait(ep, &ev, 1, 0) == 1);
+    assert(read(fd, &value, sizeof(value)) == sizeof(value) && value == 1);
+    
+    // A partial drain re-arms the eventfd, a full drain clears it
+    assert(blocking_queue_receive_batch(&bq, items, 3) == 3);
+    assert(items[0] == 0 && items[2] == 2);
+    assert(epoll_wait(ep, &ev, 1, 0) == 1);
+    assert(blocking_queue_receive_batch(&bq, items, sizeof(items)) == 2);
+    assert(epoll_wait(ep, &ev, 1, 0) == 0);
+    
+    // The loop reads the eventfd itself, then takes one item at a time: the
+    // fd stays readable until the last one is gone
+    for (uint8_t i = 0; i < 3; i++) {
+        blocking_queue_send(&bq, i, QUEUE_NO_WAIT);
+    }
+    assert(read(fd, &value, sizeof(value)) == sizeof(value));
+    assert(epoll_wait(ep, &ev, 1, 0) == 0);
+    assert(blocking_queue_receive(&bq, &items[0], QUEUE_NO_WAIT));
+    assert(epoll_wait(ep, &ev, 1, 0) == 1);
+    assert(blocking_queue_receive(&bq, &items[0], QUEUE_NO_WAIT));
+    assert(blocking_queue_receive(&bq, &items[0], QUEUE_NO_WAIT) && items[0] == 2);
+    assert(epoll_wait(ep, &ev, 1, 0) == 0);
+    
+    // Event loop wakes and drains a producer thread's burst in batches
+    pthread_t thread;
+    uint32_t total = 0;
+    pthread_create(&thread, NULL, burst_producer, NULL);
+    while (total < 20) {
+        assert(epoll_wait(ep, &ev, 1, 1000) == 1);
+        uint32_t n = blocking_queue_receive_batch(&bq, items, sizeof(items));
+        for (uint32_t i = 0; i < n; i++) {
+            assert(items[i] == total + i);
+        }
+        total += n;
+    }
+    pthread_join(thread, NULL);
+    assert(epoll_wait(ep, &ev, 1, 0) == 0);
+    
+    close(ep);
+    blocking_queue_destroy(&bq);
+    printf("✓ test_blocking_queue_eventfd passed\n");
+}
+
+int main(void) {
+    printf("Running blocking queue tests...\n");
+    
+    test_blocking_queue_timeout();
+    test_blocking_queue_marks_task_blocked();
+    test_blocking_queue_keeps_suspended_state();
+    test_blocking_queue_eventfd();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "broadcast_ring.h"
+
+#define RING_CAPACITY 8
+#define STRESS_EVENTS 50000u
+#define STRESS_CONSUMERS 3
+
+static uint8_t storage[BROADCAST_RING_STORAGE_SIZE(RING_CAPACITY, sizeof(uint32_t))];
+static broadcast_ring_t ring;
+static int consumer_ids[STRESS_CONSUMERS];
+
+static void* consumer_task(void* arg) {
+    int id = *(int*)arg;
+    uint32_t event;
+    for (uint32_t expected = 0; expected < STRESS_EVENTS; expected++) {
+        while (!broadcast_ring_poll(&ring, id, &event)) {
+            sched_yield();
+        }
+        assert(event == expected);
+    }
+    return NULL;
+}
+
+// Test cases
+void test_broadcast_ring_gated(void) {
+    uint32_t event;
+    
+    assert(broadcast_ring_init(&ring, storage, RING_CAPACITY, sizeof(uint32_t), false));
+    int fast = broadcast_ring_subscribe(&ring);
+    int slow = broadcast_ring_subscribe(&ring);
+    assert(fast >= 0 && slow >= 0 && fast != slow);
+    
+    for (event = 0; event < RING_CAPACITY; event++) {
+        assert(broadcast_ring_publish(&ring, &event, QUEUE_NO_WAIT) == true);
+    }
+    
+    // The fast consumer draining does not free slots the slow one needs
+    uint32_t out;
+    for (uint32_t i = 0; i < RING_CAPACITY; i++) {
+        assert(broadcast_ring_poll(&ring, fast, &out) && out == i);
+    }
+    assert(broadcast_ring_poll(&ring, fast, &out) == false);
+    assert(broadcast_ring_publish(&ring, &event, QUEUE_NO_WAIT) == false);
+    assert(broadcast_ring_publish(&ring, &event, 5) == false);
+    
+    assert(broadcast_ring_poll(&ring, slow, &out) && out == 0);
+    assert(broadcast_ring_publish(&ring, &event, QUEUE_NO_WAIT) == true);
+    
+    // Unsubscribing the slow consumer releases the writer
+    broadcast_ring_unsubscribe(&ring, slow);
+    event++;
+    assert(broadcast_ring_publish(&ring, &event, QUEUE_NO_WAIT) == true);
+    assert(broadcast_ring_poll(&ring, fast, &out) && out == RING_CAPACITY);
+    assert(broadcast_ring_poll(&ring, fast, &out) && out == RING_CAPACITY + 1);
+    
+    printf("✓ test_broadcast_ring_gated passed\n");
+}
+
+void test_broadcast_ring_overwrite(void) {
+    uint32_t event, out;
+    
+    assert(broadcast_ring_init(&ring, storage, RING_CAPACITY, sizeof(uint32_t), true));
+    int consumer = broadcast_ring_subscribe(&ring);
+    
+    for (event = 0; event < 20; event++) {
+        assert(broadcast_ring_publish(&ring, &event, QUEUE_NO_WAIT) == true);
+    }
+    
+    // Only the newest capacity - 1 events are guaranteed intact
+    assert(broadcast_ring_poll(&ring, consumer, &out) && out == 20 - RING_CAPACITY + 1);
+    assert(broadcast_ring_lost(&ring, consumer) == 20 - RING_CAPACITY + 1);
+    
+    printf("✓ test_broadcast_ring_overwrite passed\n");
+}
+
+void test_broadcast_ring_every_consumer_sees_every_event(void) {
+    pthread_t threads[STRESS_CONSUMERS];
+    
+    assert(broadcast_ring_init(&ring, storage, RING_CAPACITY, sizeof(uint32_t), false));
+    for (int i = 0; i < STRESS_CONSUMERS; i++) {
+        consumer_ids[i] = broadcast_ring_subscribe(&ring);
+        pthread_create(&threads[i], NULL, consumer_task, &consumer_ids[i]);
+    }
+    
+    for (uint32_t event = 0; event < STRESS_EVENTS; event++) {
+        assert(broadcast_ring_publish(&ring, &event, QUEUE_WAIT_FOREVER) == true);
+    }
+    for (int i = 0; i < STRESS_CONSUMERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    printf("✓ test_broadcast_ring_every_consumer_sees_every_event passed\n");
+}
+
+int main(void) {
+    printf("Running broadcast ring tests...\n");
+    
+    test_broadcast_ring_gated();
+    test_broadcast_ring_overwrite();
+    test_broadcast_ring_every_consumer_sees_every_event();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "coroutine.h"
+#include "task_manager.h"
+
+#define MILLION_TASKS  1000000
+
+static green_sched_t sched;
+static char trace[64];
+static uint32_t trace_len = 0;
+
+static void record(char c) {
+    if (trace_len < sizeof(trace) - 1) {
+        trace[trace_len++] = c;
+    }
+    trace[trace_len] = '\0';
+}
+
+static void reset_trace(void) {
+    trace_len = 0;
+    trace[0] = '\0';
+}
+
+// Coroutine state lives in its argument, not in locals
+typedef struct {
+    char name;
+    int i;
+} counter_t;
+
+static co_status_t counting_co(co_task_t* co, void* arg) {
+    counter_t* state = arg;
+    CO_BEGIN(co);
+    for (state->i = 0; state->i < 3; state->i++) {
+        record(state->name);
+        CO_YIELD(co);
+    }
+    CO_END(co);
+}
+
+static void stackful_task(void* arg) {
+    for (int i = 0; i < 3; i++) {
+        record(*(const char*)arg);
+        green_yield();
+    }
+}
+
+static bool flag = false;
+
+static co_status_t waiting_co(co_task_t* co, void* arg) {
+    (void)arg;
+    CO_BEGIN(co);
+    CO_WAIT_UNTIL(co, flag);
+    record('w');
+    CO_END(co);
+}
+
+static co_status_t setting_co(co_task_t* co, void* arg) {
+    (void)arg;
+    CO_BEGIN(co);
+    record('s');
+    CO_YIELD(co);
+    flag = true;
+    CO_END(co);
+}
+
+static co_status_t sleeping_co(co_task_t* co, void* arg) {
+    const uint32_t* ms = arg;
+    CO_BEGIN(co);
+    CO_SLEEP_NS(co, (uint64_t)*ms * 1000000u);
+    record((char)('0' + *ms));
+    CO_END(co);
+}
+
+static co_task_t blocked;
+
+static co_status_t blocking_co(co_task_t* co, void* arg) {
+    (void)arg;
+    CO_BEGIN(co);
+    record('b');
+    CO_BLOCK(co);
+    record('w');
+    CO_EXIT(co);
+    record('x');
+    CO_END(co);
+}
+
+static co_status_t waking_co(co_task_t* co, void* arg) {
+    (void)arg;
+    CO_BEGIN(co);
+    assert(task_get(blocked.node.task_id)->state == TASK_BLOCKED);
+    record('k');
+    assert(co_wake(&blocked) == true);
+    assert(co_kill(co) == false);
+    CO_END(co);
+}
+
+static uint32_t million_done = 0;
+
+static co_status_t million_co(co_task_t* co, void* arg) {
+    (void)arg;
+    CO_BEGIN(co);
+    CO_YIELD(co);
+    CO_YIELD(co);
+    million_done++;
+    CO_END(co);
+}
+
+// Test cases
+void test_coroutine_mixed_scheduling(void) {
+    co_task_t cos[2];
+    co_task_t rejected;
+    green_task_t thread;
+    counter_t counters[2] = { { 'a', 0 }, { 'H', 0 } };
+    
+    task_manager_init();
+    green_sched_init(&sched);
+    reset_trace();
+    assert(task_create(1, "CoLow", 1, 0) == true);
+    assert(task_create(2, "CoHigh", 5, 0) == true);
+    assert(task_create(3, "Thread", 1, 4096) == true);
+    assert(co_spawn(&sched, &cos[0], 1, counting_co, &counters[0]) == true);
+    assert(co_spawn(&sched, &cos[1], 2, counting_co, &counters[1]) == true);
+    assert(green_spawn(&sched, &thread, 3, stackful_task, "t") == true);
+    assert(co_spawn(&sched, &rejected, 99, counting_co, NULL) == false);
+    
+    green_sched_run(&sched);
+    
+    // Coroutines and stackful tasks share the priority order and the
+    // round robin within a priority
+    assert(strcmp(trace, "HHHatatat") == 0);
+    assert(task_get_count() == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_coroutine_mixed_scheduling passed\n");
+}
+
+void test_coroutine_wait_until(void) {
+    co_task_t waiter;
+    co_task_t setter;
+    
+    green_sched_init(&sched);
+    reset_trace();
+    task_create(1, "Waiter", 1, 0);
+    task_create(2, "Setter", 1, 0);
+    co_spawn(&sched, &waiter, 1, waiting_co, NULL);
+    co_spawn(&sched, &setter, 2, setting_co, NULL);
+    green_sched_run(&sched);
+    assert(strcmp(trace, "sw") == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_coroutine_wait_until passed\n");
+}
+
+void test_coroutine_sleep_order(void) {
+    co_task_t cos[3];
+    const uint32_t delays[3] = { 6, 2, 4 };
+    
+    green_sched_init(&sched);
+    reset_trace();
+    for (uint32_t i = 0; i < 3; i++) {
+        assert(task_create(i + 1, "Sleeper", 1, 0) == true);
+        assert(co_spawn(&sched, &cos[i], i + 1, sleeping_co, (void*)&delays[i]) == true);
+    }
+    green_sched_run(&sched);
+    assert(strcmp(trace, "246") == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_coroutine_sleep_order passed\n");
+}
+
+void test_coroutine_block_wake_kill(void) {
+    co_task_t waker;
+    co_task_t victim;
+    counter_t counter = { 'v', 0 };
+    
+    green_sched_init(&sched);
+    reset_trace();
+    task_create(1, "Blocked", 2, 0);
+    task_create(2, "Waker", 1, 0);
+    task_create(3, "Victim", 1, 0);
+    co_spawn(&sched, &blocked, 1, blocking_co, NULL);
+    co_spawn(&sched, &waker, 2, waking_co, NULL);
+    co_spawn(&sched, &victim, 3, counting_co, &counter);
+    
+    assert(co_kill(&victim) == true);
+    assert(task_get(3) == NULL);
+    
+    green_sched_run(&sched);
+    // CO_EXIT ends the coroutine before 'x'
+    assert(strcmp(trace, "bkw") == 0);
+    assert(task_get_count() == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_coroutine_block_wake_kill passed\n");
+}
+
+void test_coroutine_million_tasks(void) {
+    // Tens of bytes per coroutine on top of the task record
+    assert(sizeof(co_task_t) <= 80);
+    co_task_t* cos = malloc(MILLION_TASKS * sizeof(co_task_t));
+    assert(cos != NULL);
+    
+    assert(task_manager_init_capacity(MILLION_TASKS) == true);
+    green_sched_init(&sched);
+    for (uint32_t i = 0; i < MILLION_TASKS; i++) {
+        assert(task_create(i, "Co", i % 8, 0) == true);
+        assert(co_spawn(&sched, &cos[i], i, million_co, NULL) == true);
+    }
+    assert(task_get_count() == MILLION_TASKS);
+    
+    green_sched_run(&sched);
+    assert(million_done == MILLION_TASKS);
+    assert(task_get_count() == 0);
+    green_sched_destroy(&sched);
+    task_manager_init();
+    free(cos);
+    printf("✓ test_coroutine_million_tasks passed\n");
+}
+
+int main(void) {
+    printf("Running coroutine tests...\n");
+    
+    test_coroutine_mixed_scheduling();
+    test_coroutine_wait_until();
+    test_coroutine_sleep_order();
+    test_coroutine_block_wake_kill();
+    test_coroutine_million_tasks();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
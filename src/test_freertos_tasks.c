@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_manager.h"
+
+#define STACK_DEPTH 256
+
+static StackType_t stack_high[STACK_DEPTH];
+static StackType_t stack_low[STACK_DEPTH];
+static StaticTask_t tcb_high;
+static StaticTask_t tcb_low;
+
+static char run_log[32];
+static uint32_t run_log_len = 0;
+static volatile bool high_done = false;
+static bool state_ok = true;
+
+static void log_run(char c) {
+    if (run_log_len < sizeof(run_log) - 1) {
+        run_log[run_log_len++] = c;
+    }
+}
+
+static void idle_task(void* params) {
+    (void)params;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
+static void high_task(void* params) {
+    assert(params == &tcb_high);
+    for (int i = 0; i < 3; i++) {
+        log_run('H');
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    high_done = true;
+    // Returning deletes the task
+}
+
+static void low_task(void* params) {
+    (void)params;
+    uint32_t id;
+    
+    assert(uxTaskPriorityGet(NULL) == 1);
+    assert(task_get_current(&id) == true);
+    state_ok = task_get(id)->state == TASK_RUNNING;
+    log_run('L');
+    while (!high_done) {
+        vTaskDelay(1);
+    }
+    log_run('L');
+    vTaskEndScheduler();
+}
+
+static UBaseType_t mark_in_task = 0;
+
+static void stack_task(void* params) {
+    (void)params;
+    volatile uint8_t scratch[512];
+    for (uint32_t i = 0; i < sizeof(scratch); i++) {
+        scratch[i] = (uint8_t)i;
+    }
+    mark_in_task = uxTaskGetStackHighWaterMark(NULL);
+    vTaskEndScheduler();
+}
+
+static void resumable_task(void* params) {
+    (void)params;
+    log_run('A');
+    vTaskEndScheduler();
+    log_run('B');
+    vTaskEndScheduler();
+    log_run('C');
+}
+
+// Test cases
+void test_without_task_manager_init(void) {
+    // Runs first: nothing in this process has called task_manager_init
+    assert(task_get(1) == NULL);
+    assert(task_set_state(1, TASK_RUNNING) == false);
+    assert(task_create(1, "Early", 1, 0) == true);
+    assert(task_get(1) != NULL);
+    assert(task_delete(1) == true);
+    
+    TaskHandle_t handle = xTaskCreateStatic(idle_task, "Early", STACK_DEPTH, NULL,
+                                            1, stack_high, &tcb_high);
+    assert(handle != NULL);
+    assert(task_get(handle->task_id) != NULL);
+    vTaskDelete(handle);
+    assert(task_get_count() == 0);
+    printf("✓ test_without_task_manager_init passed\n");
+}
+
+void test_xTaskCreateStatic_registers_task(void) {
+    const char* long_name = "AVeryLongTaskNameIndeed";
+    
+    task_manager_init();
+    TaskHandle_t handle = xTaskCreateStatic(idle_task, long_name, STACK_DEPTH, NULL,
+                                            2, stack_high, &tcb_high);
+    assert(handle == (TaskHandle_t)&tcb_high);
+    assert(handle->pxStack == stack_high);
+    assert(handle->pxTopOfStack == &stack_high[STACK_DEPTH - 1]);
+    assert(strlen(handle->pcTaskName) == configMAX_TASK_NAME_LEN - 1);
+    assert(strncmp(handle->pcTaskName, long_name, configMAX_TASK_NAME_LEN - 1) == 0);
+    assert(handle->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB);
+    assert(uxTaskPriorityGet(handle) == 2);
+    
+    // Registered with the task manager under its own id
+    task_t* task = task_get(handle->task_id);
+    assert(task != NULL);
+    assert(task->state == TASK_READY);
+    assert(task->priority == 2);
+    assert(uxTaskGetNumberOfTasks() == 1);
+    
+    // Handing the same TCB in again replaces the earlier task
+    handle = xTaskCreateStatic(idle_task, "Again", STACK_DEPTH, NULL,
+                               1, stack_high, &tcb_high);
+    assert(handle != NULL);
+    assert(uxTaskGetNumberOfTasks() == 1);
+    assert(task_get_count() == 1);
+    
+    vTaskDelete(handle);
+    assert(uxTaskGetNumberOfTasks() == 0);
+    assert(task_get_count() == 0);
+    printf("✓ test_xTaskCreateStatic_registers_task passed\n");
+}
+
+void test_xTaskCreateStatic_validates_arguments(void) {
+    assert(xTaskCreateStatic(NULL, "T", STACK_DEPTH, NULL, 1, stack_high, &tcb_high) == NULL);
+    assert(xTaskCreateStatic(idle_task, "T", STACK_DEPTH, NULL, 1, NULL, &tcb_high) == NULL);
+    assert(xTaskCreateStatic(idle_task, "T", STACK_DEPTH, NULL, 1, stack_high, NULL) == NULL);
+    
+    // Priorities above the configured range are capped
+    TaskHandle_t handle = xTaskCreateStatic(idle_task, NULL, STACK_DEPTH, NULL,
+                                            configMAX_PRIORITIES + 5, stack_high, &tcb_high);
+    assert(handle != NULL);
+    assert(handle->pcTaskName[0] == '\0');
+    assert(uxTaskPriorityGet(handle) == configMAX_PRIORITIES - 1);
+    vTaskDelete(handle);
+    printf("✓ test_xTaskCreateStatic_validates_arguments passed\n");
+}
+
+void test_scheduler_runs_by_priority(void) {
+    TaskHandle_t low = xTaskCreateStatic(low_task, "Low", STACK_DEPTH, NULL,
+                                         1, stack_low, &tcb_low);
+    TaskHandle_t high = xTaskCreateStatic(high_task, "High", STACK_DEPTH, &tcb_high,
+                                          2, stack_high, &tcb_high);
+    assert(low && high);
+    
+    TickType_t start = xTaskGetTickCount();
+    vTaskStartScheduler();
+    
+    // High runs first; Low only gets the CPU while High is delayed
+    run_log[run_log_len] = '\0';
+    assert(strcmp(run_log, "HLHHL") == 0);
+    assert(state_ok == true);
+    assert(xTaskGetTickCount() - start >= pdMS_TO_TICKS(15));
+    
+    // High returned from its function and was deleted; Low is stopped
+    assert(uxTaskGetNumberOfTasks() == 1);
+    assert(task_get(low->task_id)->state == TASK_SUSPENDED);
+    vTaskDelete(low);
+    printf("✓ test_scheduler_runs_by_priority passed\n");
+}
+
+void test_stack_high_water_mark(void) {
+    TaskHandle_t handle = xTaskCreateStatic(stack_task, "Stack", STACK_DEPTH, NULL,
+                                            1, stack_low, &tcb_low);
+    assert(handle != NULL);
+    
+    // Painted at creation: untouched until the task first runs
+    assert(uxTaskGetStackHighWaterMark(handle) == STACK_DEPTH);
+    vTaskStartScheduler();
+    
+    // The scratch buffer alone takes 512 bytes
+    assert(mark_in_task > 0);
+    assert(mark_in_task <= STACK_DEPTH - 512 / sizeof(StackType_t));
+    assert(uxTaskGetStackHighWaterMark(handle) <= mark_in_task);
+    vTaskDelete(handle);
+    printf("✓ test_stack_high_water_mark passed\n");
+}
+
+void test_scheduler_resumes_stopped_tasks(void) {
+    run_log_len = 0;
+    TaskHandle_t handle = xTaskCreateStatic(resumable_task, "Resume", STACK_DEPTH, NULL,
+                                            1, stack_low, &tcb_low);
+    assert(handle != NULL);
+    
+    // Each start carries on after the vTaskEndScheduler that ended the last
+    vTaskStartScheduler();
+    assert(task_get(handle->task_id)->state == TASK_SUSPENDED);
+    vTaskStartScheduler();
+    run_log[run_log_len] = '\0';
+    assert(strcmp(run_log, "AB") == 0);
+    vTaskStartScheduler();
+    run_log[run_log_len] = '\0';
+    assert(strcmp(run_log, "ABC") == 0);
+    assert(uxTaskGetNumberOfTasks() == 0);
+    
+    // Stopped tasks can still be deleted before the next start
+    run_log_len = 0;
+    handle = xTaskCreateStatic(resumable_task, "Resume", STACK_DEPTH, NULL,
+                               1, stack_low, &tcb_low);
+    vTaskStartScheduler();
+    vTaskDelete(handle);
+    assert(task_get_count() == 0);
+    vTaskStartScheduler();
+    run_log[run_log_len] = '\0';
+    assert(strcmp(run_log, "A") == 0);
+    printf("✓ test_scheduler_resumes_stopped_tasks passed\n");
+}
+
+void test_scheduler_does_not_start_on_spawn_failure(void) {
+    run_log_len = 0;
+    TaskHandle_t good = xTaskCreateStatic(resumable_task, "Good", STACK_DEPTH, NULL,
+                                          1, stack_low, &tcb_low);
+    TaskHandle_t lost = xTaskCreateStatic(idle_task, "Lost", STACK_DEPTH, NULL,
+                                          2, stack_high, &tcb_high);
+    assert(good && lost);
+    
+    // A task whose record is gone cannot be spawned: nothing runs
+    assert(task_delete(lost->task_id) == true);
+    vTaskStartScheduler();
+    assert(run_log_len == 0);
+    
+    vTaskDelete(lost);
+    vTaskStartScheduler();
+    run_log[run_log_len] = '\0';
+    assert(strcmp(run_log, "A") == 0);
+    vTaskDelete(good);
+    assert(task_get_count() == 0);
+    printf("✓ test_scheduler_does_not_start_on_spawn_failure passed\n");
+}
+
+int main(void) {
+    printf("Running FreeRTOS task shim tests...\n");
+    
+    test_without_task_manager_init();
+    test_xTaskCreateStatic_registers_task();
+    test_xTaskCreateStatic_validates_arguments();
+    test_scheduler_runs_by_priority();
+    test_stack_high_water_mark();
+    test_scheduler_resumes_stopped_tasks();
+    test_scheduler_does_not_start_on_spawn_failure();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,265 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "green_thread.h"
+#include "task_manager.h"
+
+#define MANY_TASKS  2000
+#define MANY_YIELDS 10
+
+static green_sched_t sched;
+static char trace[64];
+static uint32_t trace_len = 0;
+
+static void record(char c) {
+    if (trace_len < sizeof(trace) - 1) {
+        trace[trace_len++] = c;
+    }
+    trace[trace_len] = '\0';
+}
+
+static void reset_trace(void) {
+    trace_len = 0;
+    trace[0] = '\0';
+}
+
+static void yielding_task(void* arg) {
+    char c = *(const char*)arg;
+    for (int i = 0; i < 3; i++) {
+        record(c);
+        green_yield();
+    }
+}
+
+static void sleeping_task(void* arg) {
+    uint32_t ms = *(const uint32_t*)arg;
+    green_sleep_ns((uint64_t)ms * 1000000u);
+    record((char)('0' + ms));
+}
+
+static uint8_t static_stack[8192];
+static bool on_static_stack = false;
+
+static void stack_check_task(void* arg) {
+    (void)arg;
+    uint8_t local;
+    on_static_stack = &local >= static_stack && &local < static_stack + sizeof(static_stack);
+}
+
+static void api_task(void* arg) {
+    (void)arg;
+    // The first sleep grows the sleep heap; that must not happen here
+    green_sleep_ns(1000);
+    green_yield();
+    green_sleep_ns(1000);
+}
+
+static void overflow_task(void* arg) {
+    uint32_t id;
+    (void)arg;
+    assert(task_get_current(&id) == true);
+    // Stands in for a frame running past the far end of the stack
+    memset(task_get(id)->stack, 0, STACK_CANARY_SIZE);
+    green_yield();
+}
+
+static green_task_t waiter;
+static green_task_t waker;
+
+static void waiter_task(void* arg) {
+    (void)arg;
+    record('b');
+    green_block();
+    record('w');
+}
+
+static void waker_task(void* arg) {
+    (void)arg;
+    uint32_t id;
+    assert(task_get_current(&id) == true);
+    assert(task_get(waiter.node.task_id)->state == TASK_BLOCKED);
+    record('k');
+    green_wake(&waiter);
+}
+
+static uint32_t many_done = 0;
+
+static void many_task(void* arg) {
+    (void)arg;
+    for (int i = 0; i < MANY_YIELDS; i++) {
+        green_yield();
+    }
+    many_done++;
+}
+
+// Test cases
+void test_green_priority_and_round_robin(void) {
+    green_task_t tasks[3];
+    const char names[3] = { 'a', 'b', 'H' };
+    
+    task_manager_init();
+    green_sched_init(&sched);
+    reset_trace();
+    assert(task_create(1, "A", 1, 4096) == true);
+    assert(task_create(2, "B", 1, 4096) == true);
+    assert(task_create(3, "High", 5, 4096) == true);
+    for (uint32_t i = 0; i < 3; i++) {
+        assert(green_spawn(&sched, &tasks[i], i + 1, yielding_task, (void*)&names[i]) == true);
+    }
+    
+    green_sched_run(&sched);
+    
+    // The high-priority task runs to completion first; equal ones alternate
+    assert(strcmp(trace, "HHHababab") == 0);
+    // Finished tasks are deleted, returning their pool stacks
+    assert(task_get_count() == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_green_priority_and_round_robin passed\n");
+}
+
+void test_green_caller_stack(void) {
+    green_task_t task;
+    
+    green_sched_init(&sched);
+    assert(task_create(1, "NoStack", 1, 0) == true);
+    assert(green_spawn(&sched, &task, 1, stack_check_task, NULL) == false);
+    assert(task_delete(1) == true);
+    
+    assert(task_create_static(2, "Static", 1, static_stack, sizeof(static_stack)) == true);
+    assert(task_get(2)->owns_stack == false);
+    assert(green_spawn(&sched, &task, 2, stack_check_task, NULL) == true);
+    green_sched_run(&sched);
+    assert(on_static_stack == true);
+    green_sched_destroy(&sched);
+    printf("✓ test_green_caller_stack passed\n");
+}
+
+void test_green_scheduler_stack_use(void) {
+    green_task_t task;
+    
+    green_sched_init(&sched);
+    assert(task_create_static(1, "Api", 1, static_stack, sizeof(static_stack)) == true);
+    assert(green_spawn(&sched, &task, 1, api_task, NULL) == true);
+    green_sched_run(&sched);
+    
+    // Sleep heap growth and task state updates run on the scheduler stack,
+    // leaving most of a minimum-size stack to the task itself
+    uint32_t used = sizeof(static_stack) - stack_unused_bytes(static_stack, sizeof(static_stack));
+    assert(used > 0);
+    assert(used < STACK_MIN_SIZE / 2);
+    green_sched_destroy(&sched);
+    printf("✓ test_green_scheduler_stack_use passed\n");
+}
+
+void test_green_stack_overflow_detected(void) {
+    int status;
+    
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        green_task_t task;
+        freopen("/dev/null", "w", stderr);
+        green_sched_init(&sched);
+        task_create(1, "Overflow", 1, STACK_MIN_SIZE);
+        green_spawn(&sched, &task, 1, overflow_task, NULL);
+        green_sched_run(&sched);
+        _exit(0);
+    }
+    
+    // The switch back to the scheduler finds the canary gone
+    waitpid(pid, &status, 0);
+    assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+    
+    // A task exactly at the minimum is accepted, one below is not
+    green_task_t task;
+    green_sched_init(&sched);
+    assert(task_create(1, "Small", 1, STACK_MIN_SIZE - 16) == true);
+    assert(green_spawn(&sched, &task, 1, api_task, NULL) == false);
+    assert(task_create(2, "Min", 1, STACK_MIN_SIZE) == true);
+    assert(green_spawn(&sched, &task, 2, api_task, NULL) == true);
+    green_sched_run(&sched);
+    assert(task_delete(1) == true);
+    green_sched_destroy(&sched);
+    printf("✓ test_green_stack_overflow_detected passed\n");
+}
+
+void test_green_sleep_order(void) {
+    green_task_t tasks[3];
+    const uint32_t delays[3] = { 6, 2, 4 };
+    
+    green_sched_init(&sched);
+    reset_trace();
+    for (uint32_t i = 0; i < 3; i++) {
+        assert(task_create(i + 1, "Sleeper", 1, 4096) == true);
+        assert(green_spawn(&sched, &tasks[i], i + 1, sleeping_task, (void*)&delays[i]) == true);
+    }
+    green_sched_run(&sched);
+    assert(strcmp(trace, "246") == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_green_sleep_order passed\n");
+}
+
+void test_green_block_wake_kill(void) {
+    green_task_t victim;
+    
+    green_sched_init(&sched);
+    reset_trace();
+    task_create(1, "Waiter", 2, 4096);
+    task_create(2, "Waker", 1, 4096);
+    task_create(3, "Victim", 1, 4096);
+    green_spawn(&sched, &waiter, 1, waiter_task, NULL);
+    green_spawn(&sched, &waker, 2, waker_task, NULL);
+    green_spawn(&sched, &victim, 3, yielding_task, "v");
+    
+    // A task killed before it runs never starts
+    assert(green_kill(&victim) == true);
+    assert(task_get(3) == NULL);
+    assert(green_kill(&victim) == false);
+    
+    green_sched_run(&sched);
+    assert(strcmp(trace, "bkw") == 0);
+    assert(task_get_count() == 0);
+    green_sched_destroy(&sched);
+    printf("✓ test_green_block_wake_kill passed\n");
+}
+
+void test_green_many_tasks(void) {
+    static green_task_t tasks[MANY_TASKS];
+    
+    assert(task_manager_init_capacity(MANY_TASKS) == true);
+    assert(task_get_capacity() == MANY_TASKS);
+    green_sched_init(&sched);
+    for (uint32_t i = 0; i < MANY_TASKS; i++) {
+        assert(task_create(i, "Many", i % 4, 2048) == true);
+        assert(green_spawn(&sched, &tasks[i], i, many_task, NULL) == true);
+    }
+    assert(task_create(MANY_TASKS, "Extra", 1, 2048) == false);
+    
+    green_sched_run(&sched);
+    assert(many_done == MANY_TASKS);
+    assert(task_get_count() == 0);
+    green_sched_destroy(&sched);
+    task_manager_init();
+    printf("✓ test_green_many_tasks passed\n");
+}
+
+int main(void) {
+    printf("Running green thread tests...\n");
+    
+    test_green_priority_and_round_robin();
+    test_green_caller_stack();
+    test_green_scheduler_stack_use();
+    test_green_stack_overflow_detected();
+    test_green_sleep_order();
+    test_green_block_wake_kill();
+    test_green_many_tasks();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,210 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include "mailbox.h"
+
+#define LARGE_CAPACITY 300   // several pool chunks and table doublings
+
+static uint8_t received_msg;
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void* receiver_task(void* arg) {
+    (void)arg;
+    task_set_state(3, TASK_RUNNING);
+    assert(mailbox_receive(3, &received_msg, QUEUE_WAIT_FOREVER) == true);
+    return NULL;
+}
+
+static bool waiter_received = true;
+
+static void* deleted_task_receiver(void* arg) {
+    uint8_t msg;
+    waiter_received = mailbox_receive(*(const uint32_t*)arg, &msg, QUEUE_WAIT_FOREVER);
+    return NULL;
+}
+
+static void wait_blocked(uint32_t task_id) {
+    for (int i = 0; i < 1000 && task_get(task_id)->state != TASK_BLOCKED; i++) {
+        sleep_ms(1);
+    }
+    assert(task_get(task_id)->state == TASK_BLOCKED);
+}
+
+// Test cases
+void test_mailbox_send_receive(void) {
+    uint8_t msg;
+    
+    task_manager_init();
+    task_create(1, "Task1", 1, 512);
+    task_create(2, "Task2", 1, 512);
+    
+    // Unknown tasks have no mailbox
+    assert(mailbox_send(99, 1, QUEUE_NO_WAIT) == false);
+    assert(mailbox_pending(1) == 0);
+    
+    assert(mailbox_send(1, 10, QUEUE_NO_WAIT) == true);
+    assert(mailbox_send(2, 20, QUEUE_NO_WAIT) == true);
+    assert(mailbox_send(1, 11, QUEUE_NO_WAIT) == true);
+    assert(mailbox_pending(1) == 2);
+    assert(mailbox_pending(2) == 1);
+    
+    assert(mailbox_receive(1, &msg, QUEUE_NO_WAIT) && msg == 10);
+    assert(mailbox_receive(1, &msg, QUEUE_NO_WAIT) && msg == 11);
+    assert(mailbox_receive(1, &msg, 5) == false);
+    assert(task_get(1)->state == TASK_RUNNING);
+    assert(mailbox_receive(2, &msg, QUEUE_NO_WAIT) && msg == 20);
+    
+    for (uint8_t i = 0; i < MAILBOX_DEPTH; i++) {
+        assert(mailbox_send(2, i, QUEUE_NO_WAIT) == true);
+    }
+    assert(mailbox_send(2, 0, QUEUE_NO_WAIT) == false);
+    
+    printf("✓ test_mailbox_send_receive passed\n");
+}
+
+void test_mailbox_released_with_task(void) {
+    task_manager_init();
+    
+    // Every task can hold a mailbox at once
+    for (uint32_t id = 100; id < 100 + MAX_TASKS; id++) {
+        task_create(id, "Task", 1, 512);
+        assert(mailbox_send(id, 1, QUEUE_NO_WAIT) == true);
+    }
+    
+    // Deleting a task returns its mailbox and pending messages to the pool
+    assert(task_delete(100) == true);
+    assert(mailbox_pending(100) == 0);
+    task_create(200, "Reused", 1, 512);
+    assert(mailbox_pending(200) == 0);
+    assert(mailbox_send(200, 7, QUEUE_NO_WAIT) == true);
+    assert(mailbox_pending(200) == 1);
+    for (uint32_t id = 101; id < 100 + MAX_TASKS; id++) {
+        assert(mailbox_pending(id) == 1);
+    }
+    
+    printf("✓ test_mailbox_released_with_task passed\n");
+}
+
+void test_mailbox_blocks_and_readies_task(void) {
+    pthread_t thread;
+    
+    task_manager_init();
+    task_create(3, "Receiver", 2, 512);
+    
+    pthread_create(&thread, NULL, receiver_task, NULL);
+    for (int i = 0; i < 1000 && task_get(3)->state != TASK_BLOCKED; i++) {
+        sleep_ms(1);
+    }
+    assert(task_get(3)->state == TASK_BLOCKED);
+    
+    assert(mailbox_send(3, 42, QUEUE_NO_WAIT) == true);
+    task_state_t state = task_get(3)->state;
+    assert(state == TASK_READY || state == TASK_RUNNING);
+    
+    pthread_join(thread, NULL);
+    assert(received_msg == 42);
+    assert(task_get(3)->state == TASK_RUNNING);
+    
+    printf("✓ test_mailbox_blocks_and_readies_task passed\n");
+}
+
+void test_mailbox_receive_before_first_send(void) {
+    uint8_t msg;
+    
+    task_manager_init();
+    task_create(4, "Early", 1, 512);
+    assert(mailbox_receive(4, &msg, QUEUE_NO_WAIT) == false);
+    assert(mailbox_receive(4, &msg, 5) == false);
+    assert(task_get(4)->state == TASK_RUNNING);
+    assert(mailbox_receive(99, &msg, 5) == false);
+    
+    // The receives took nothing from the pool: every task still gets one
+    for (uint32_t id = 100; id < 100 + MAX_TASKS - 1; id++) {
+        task_create(id, "Task", 1, 512);
+        assert(mailbox_send(id, 1, QUEUE_NO_WAIT) == true);
+    }
+    assert(mailbox_send(4, 2, QUEUE_NO_WAIT) == true);
+    assert(mailbox_receive(4, &msg, QUEUE_NO_WAIT) && msg == 2);
+    printf("✓ test_mailbox_receive_before_first_send passed\n");
+}
+
+void test_mailbox_release_fails_waiters(void) {
+    pthread_t thread;
+    uint8_t msg;
+    uint32_t id;
+    
+    task_manager_init();
+    
+    // Parked on an existing mailbox
+    id = 5;
+    task_create(id, "Doomed", 1, 512);
+    assert(mailbox_send(id, 1, QUEUE_NO_WAIT) == true);
+    assert(mailbox_receive(id, &msg, QUEUE_NO_WAIT) == true);
+    waiter_received = true;
+    pthread_create(&thread, NULL, deleted_task_receiver, &id);
+    wait_blocked(id);
+    assert(task_delete(id) == true);
+    pthread_join(thread, NULL);
+    assert(waiter_received == false);
+    
+    // The recycled mailbox delivers to its new owner only
+    task_create(6, "Next", 1, 512);
+    assert(mailbox_send(6, 9, QUEUE_NO_WAIT) == true);
+    assert(mailbox_pending(6) == 1);
+    assert(mailbox_receive(6, &msg, QUEUE_NO_WAIT) && msg == 9);
+    
+    // Parked before the first send
+    id = 7;
+    task_create(id, "Unsent", 1, 512);
+    waiter_received = true;
+    pthread_create(&thread, NULL, deleted_task_receiver, &id);
+    wait_blocked(id);
+    assert(task_delete(id) == true);
+    pthread_join(thread, NULL);
+    assert(waiter_received == false);
+    assert(mailbox_send(id, 1, QUEUE_NO_WAIT) == false);
+    printf("✓ test_mailbox_release_fails_waiters passed\n");
+}
+
+void test_mailbox_pool_follows_task_capacity(void) {
+    uint8_t msg;
+    
+    // One mailbox per task at any task capacity
+    assert(task_manager_init_capacity(LARGE_CAPACITY) == true);
+    for (uint32_t id = 1; id <= LARGE_CAPACITY; id++) {
+        assert(task_create(id, "Task", 1, 0) == true);
+        assert(mailbox_send(id, (uint8_t)id, QUEUE_NO_WAIT) == true);
+    }
+    for (uint32_t id = 1; id <= LARGE_CAPACITY; id++) {
+        assert(mailbox_receive(id, &msg, QUEUE_NO_WAIT) && msg == (uint8_t)id);
+    }
+    
+    // Back to the static default
+    task_manager_init();
+    task_create(1, "Task", 1, 0);
+    assert(mailbox_pending(1) == 0);
+    assert(mailbox_send(1, 3, QUEUE_NO_WAIT) == true);
+    assert(mailbox_pending(1) == 1);
+    printf("✓ test_mailbox_pool_follows_task_capacity passed\n");
+}
+
+int main(void) {
+    printf("Running mailbox tests...\n");
+    
+    test_mailbox_send_receive();
+    test_mailbox_released_with_task();
+    test_mailbox_blocks_and_readies_task();
+    test_mailbox_receive_before_first_send();
+    test_mailbox_release_fails_waiters();
+    test_mailbox_pool_follows_task_capacity();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include "mem_pool.h"
+#include "task_manager.h"
+#include "stream_buffer.h"
+
+#define THREAD_BLOCKS 100
+#define STACK_BYTES   8192
+#define EXTRA_TASKS   16
+
+static void* thread_blocks[THREAD_BLOCKS];
+
+static void* alloc_and_exit(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < THREAD_BLOCKS; i++) {
+        thread_blocks[i] = mem_pool_alloc(48);
+    }
+    return NULL;
+}
+
+static void* free_and_exit(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < THREAD_BLOCKS; i++) {
+        mem_pool_free(thread_blocks[i]);
+    }
+    return NULL;
+}
+
+// Test cases
+void test_mem_pool_size_classes(void) {
+    int local;
+    
+    assert(mem_pool_init() == true);
+    assert(mem_pool_alloc(0) == NULL);
+    assert(mem_pool_alloc(MEM_POOL_MAX_BLOCK + 1) == NULL);
+    
+    void* a = mem_pool_alloc(1);
+    void* b = mem_pool_alloc(17);
+    void* c = mem_pool_alloc(MEM_POOL_MAX_BLOCK);
+    assert(a && b && c);
+    assert(mem_pool_block_size(a) == 16);
+    assert(mem_pool_block_size(b) == 32);
+    assert(mem_pool_block_size(c) == MEM_POOL_MAX_BLOCK);
+    assert(((uintptr_t)b % 32) == 0);
+    
+    assert(mem_pool_owns(a) == true);
+    assert(mem_pool_owns(&local) == false);
+    assert(mem_pool_block_size((uint8_t*)b + 1) == 0);
+    
+    memset(c, 0xAB, MEM_POOL_MAX_BLOCK);
+    mem_pool_free(a);
+    mem_pool_free(b);
+    mem_pool_free(c);
+    mem_pool_free(NULL);
+    
+    // The most recently freed block is handed out first
+    assert(mem_pool_alloc(20) == b);
+    mem_pool_free(b);
+    printf("✓ test_mem_pool_size_classes passed\n");
+}
+
+void test_mem_pool_exhaustion(void) {
+    static void* blocks[MEM_POOL_ARENA_SIZE / MEM_POOL_MAX_BLOCK];
+    mem_pool_class_info_t info;
+    uint32_t last = MEM_POOL_CLASSES - 1;
+    
+    assert(mem_pool_class_info(last, &info) == true);
+    assert(info.capacity == MEM_POOL_ARENA_SIZE / MEM_POOL_MAX_BLOCK);
+    assert(mem_pool_class_info(MEM_POOL_CLASSES, &info) == false);
+    
+    for (uint32_t i = 0; i < info.capacity; i++) {
+        blocks[i] = mem_pool_alloc(MEM_POOL_MAX_BLOCK);
+        assert(blocks[i] != NULL);
+    }
+    assert(mem_pool_alloc(MEM_POOL_MAX_BLOCK) == NULL);
+    
+    for (uint32_t i = 0; i < info.capacity; i++) {
+        mem_pool_free(blocks[i]);
+    }
+    assert(mem_pool_alloc(MEM_POOL_MAX_BLOCK) != NULL);
+    printf("✓ test_mem_pool_exhaustion passed\n");
+}
+
+void test_mem_pool_cross_thread(void) {
+    pthread_t thread;
+    mem_pool_class_info_t before;
+    mem_pool_class_info_t after;
+    
+    // 48-byte requests use the 64-byte class
+    assert(mem_pool_class_info(2, &before) == true);
+    
+    pthread_create(&thread, NULL, alloc_and_exit, NULL);
+    pthread_join(thread, NULL);
+    for (uint32_t i = 0; i < THREAD_BLOCKS; i++) {
+        assert(thread_blocks[i] != NULL);
+        for (uint32_t j = 0; j < i; j++) {
+            assert(thread_blocks[i] != thread_blocks[j]);
+        }
+    }
+    
+    // Blocks freed on another thread reach the shared list when it exits
+    pthread_create(&thread, NULL, free_and_exit, NULL);
+    pthread_join(thread, NULL);
+    assert(mem_pool_class_info(2, &after) == true);
+    assert(after.carved - after.shared_free == before.carved - before.shared_free);
+    printf("✓ test_mem_pool_cross_thread passed\n");
+}
+
+void test_mem_pool_task_stacks(void) {
+    task_manager_init();
+    
+    assert(task_create(1, "Task1", 5, 1024) == true);
+    task_t* task = task_get(1);
+    assert(task->stack != NULL);
+    assert(mem_pool_block_size(task->stack) == 1024);
+    void* stack = task->stack;
+    
+    // A stack larger than the biggest block comes from the heap
+    assert(task_create(2, "Huge", 1, MEM_POOL_MAX_BLOCK + 1) == true);
+    assert(task_get(2)->stack != NULL);
+    assert(mem_pool_owns(task_get(2)->stack) == false);
+    assert(task_create(5, "Huger", 1, 1u << 20) == true);
+    assert(task_delete(5) == true);
+    assert(task_create(5, "TooBig", 1, TASK_STACK_MAX_SIZE + 1) == false);
+    assert(task_get(5) == NULL);
+    
+    assert(task_create(2, "Dup", 1, 1024) == false);
+    assert(task_create(3, "NoStack", 1, 0) == true);
+    assert(task_get(3)->stack == NULL);
+    
+    assert(task_delete(1) == true);
+    assert(task_create(4, "Task4", 5, 1000) == true);
+    assert(task_get(4)->stack == stack);
+    
+    task_manager_init();
+    printf("✓ test_mem_pool_task_stacks passed\n");
+}
+
+void test_mem_pool_task_stacks_beyond_class(void) {
+    uint32_t class_blocks = MEM_POOL_ARENA_SIZE / STACK_BYTES;
+    uint32_t pooled = 0;
+    
+    // More tasks than the stack size's class holds: the rest use the heap
+    assert(task_manager_init_capacity(class_blocks + EXTRA_TASKS) == true);
+    for (uint32_t id = 1; id <= class_blocks + EXTRA_TASKS; id++) {
+        assert(task_create(id, "Many", 1, STACK_BYTES) == true);
+        pooled += mem_pool_owns(task_get(id)->stack);
+    }
+    assert(pooled <= class_blocks);
+    assert(pooled < class_blocks + EXTRA_TASKS);
+    for (uint32_t id = 1; id <= class_blocks + EXTRA_TASKS; id++) {
+        assert(task_delete(id) == true);
+    }
+    task_manager_init();
+    printf("✓ test_mem_pool_task_stacks_beyond_class passed\n");
+}
+
+void test_mem_pool_message_buffer(void) {
+    message_buffer_t mb;
+    char out[16];
+    
+    assert(message_buffer_create(&mb, 128) == true);
+    assert(mem_pool_owns(mb.storage) == true);
+    assert(message_buffer_send(&mb, "pooled", 6, 0) == 6);
+    assert(message_buffer_receive(&mb, out, sizeof(out), 0) == 6);
+    assert(memcmp(out, "pooled", 6) == 0);
+    message_buffer_destroy(&mb);
+    assert(mb.storage == NULL);
+    
+    assert(stream_buffer_create(&mb, MEM_POOL_MAX_BLOCK + 1, 1) == false);
+    printf("✓ test_mem_pool_message_buffer passed\n");
+}
+
+int main(void) {
+    printf("Running memory pool tests...\n");
+    
+    test_mem_pool_size_classes();
+    test_mem_pool_exhaustion();
+    test_mem_pool_cross_thread();
+    test_mem_pool_task_stacks();
+    test_mem_pool_task_stacks_beyond_class();
+    test_mem_pool_message_buffer();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,216 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "metrics_page.h"
+
+#define READ_ROUNDS 20000
+
+// Renders a snapshot and returns the text; the caller frees it
+static char* prometheus_text(const metrics_snapshot_t* snapshot) {
+    FILE* out = tmpfile();
+    assert(out != NULL);
+    assert(metrics_write_prometheus(snapshot, out) == true);
+    long size = ftell(out);
+    char* text = malloc((size_t)size + 1);
+    rewind(out);
+    assert(fread(text, 1, (size_t)size, out) == (size_t)size);
+    text[size] = '\0';
+    fclose(out);
+    return text;
+}
+
+// Child of the cross-process test: churns tasks and queue items and
+// publishes after every step until killed
+static void publisher_loop(metrics_page_t* metrics, queue_t* queue) {
+    uint32_t round = 0;
+    for (;;) {
+        uint32_t id = 100 + round % 4;
+        if (task_get(id)) {
+            task_delete(id);
+            queue_dequeue(queue, &(uint8_t){ 0 });
+        } else {
+            task_create(id, "Churn", 1, 0);
+            task_set_state(id, (task_state_t)(round % TASK_STATE_COUNT));
+            queue_enqueue(queue, (uint8_t)round);
+        }
+        metrics_page_publish(metrics);
+        round++;
+    }
+}
+
+// Test cases
+void test_metrics_page_publish_and_read(void) {
+    metrics_page_t writer;
+    metrics_page_t reader;
+    metrics_snapshot_t snapshot;
+    queue_t queue;
+    
+    task_manager_init();
+    queue_init(&queue, 8);
+    assert(task_create(1, "A", 1, 0) == true);
+    assert(task_create(2, "B", 1, 0) == true);
+    assert(task_create(3, "C", 2, 0) == true);
+    assert(task_set_state(2, TASK_RUNNING) == true);
+    assert(task_set_state(3, TASK_BLOCKED) == true);
+    assert(queue_enqueue(&queue, 1) == true);
+    assert(queue_enqueue(&queue, 2) == true);
+    
+    assert(metrics_page_create(&writer, NULL) == true);
+    assert(metrics_page_add_queue(&writer, "rx", &queue) == true);
+    assert(metrics_page_attach_fd(&reader, dup(writer.fd)) == true);
+    
+    // Nothing published yet: the page reads as empty
+    assert(metrics_page_read(&reader, &snapshot) == true);
+    assert(snapshot.publish_count == 0);
+    assert(snapshot.tasks.count == 0);
+    assert(snapshot.queue_count == 1);
+    
+    assert(metrics_page_publish(&writer) == true);
+    assert(metrics_page_read(&reader, &snapshot) == true);
+    assert(snapshot.publish_count == 1);
+    assert(snapshot.tasks.count == 3);
+    assert(snapshot.tasks.capacity == MAX_TASKS);
+    assert(snapshot.tasks.per_state[TASK_READY] == 1);
+    assert(snapshot.tasks.per_state[TASK_RUNNING] == 1);
+    assert(snapshot.tasks.per_state[TASK_BLOCKED] == 1);
+    assert(snapshot.tasks.transitions == 2);
+    
+    // Deleting a task keeps its transitions in the total
+    assert(task_delete(3) == true);
+    assert(metrics_page_publish(&writer) == true);
+    assert(metrics_page_read(&reader, &snapshot) == true);
+    assert(snapshot.tasks.count == 2);
+    assert(snapshot.tasks.transitions == 2);
+    assert(snapshot.latency[1].count == 1);
+    assert(strcmp(snapshot.queues[0].name, "rx") == 0);
+    assert(snapshot.queues[0].depth == 2);
+    assert(snapshot.queues[0].capacity == 8);
+    
+    // The reader's mapping is read-only
+    assert(metrics_page_publish(&reader) == false);
+    assert(metrics_page_add_queue(&reader, "tx", &queue) == false);
+    
+    metrics_page_detach(&reader);
+    metrics_page_detach(&writer);
+    task_manager_init();
+    printf("✓ test_metrics_page_publish_and_read passed\n");
+}
+
+void test_metrics_page_prometheus(void) {
+    metrics_snapshot_t snapshot;
+    
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.tasks.count = 3;
+    snapshot.tasks.capacity = 10;
+    snapshot.tasks.per_state[TASK_READY] = 2;
+    snapshot.tasks.per_state[TASK_BLOCKED] = 1;
+    snapshot.tasks.transitions = 17;
+    snapshot.latency[4].count = 9;
+    snapshot.latency[4].sum_ns = 4500000;
+    snapshot.latency[4].p50_ns = 1500;
+    snapshot.latency[4].p99_ns = 2000000;
+    snapshot.latency[4].max_ns = 3000000;
+    snapshot.queue_count = 1;
+    strcpy(snapshot.queues[0].name, "a\"b");
+    snapshot.queues[0].depth = 5;
+    snapshot.queues[0].capacity = 32;
+    
+    char* text = prometheus_text(&snapshot);
+    assert(strstr(text, "# TYPE tasks gauge\n") != NULL);
+    assert(strstr(text, "tasks{state=\"ready\"} 2\n") != NULL);
+    assert(strstr(text, "tasks{state=\"blocked\"} 1\n") != NULL);
+    assert(strstr(text, "tasks{state=\"running\"} 0\n") != NULL);
+    assert(strstr(text, "task_count") == NULL);
+    assert(strstr(text, "task_transitions_total 17\n") != NULL);
+    assert(strstr(text, "task_wake_latency_seconds{priority=\"4\",quantile=\"0.5\"} 0.000001500\n") != NULL);
+    assert(strstr(text, "task_wake_latency_seconds{priority=\"4\",quantile=\"0.99\"} 0.002000000\n") != NULL);
+    assert(strstr(text, "# TYPE task_wake_latency_seconds summary\n") != NULL);
+    assert(strstr(text, "task_wake_latency_seconds_sum{priority=\"4\"} 0.004500000\n") != NULL);
+    assert(strstr(text, "task_wake_latency_seconds_count{priority=\"4\"} 9\n") != NULL);
+    // Priorities that never woke a task are left out
+    assert(strstr(text, "priority=\"0\"") == NULL);
+    assert(strstr(text, "queue_depth{queue=\"a\\\"b\"} 5\n") != NULL);
+    // Queue counters only appear for queues built with statistics
+    assert(strstr(text, "queue_enqueued_total{") == NULL);
+    free(text);
+    
+    assert(metrics_write_prometheus(NULL, stdout) == false);
+    printf("✓ test_metrics_page_prometheus passed\n");
+}
+
+void test_metrics_page_cross_process_consistency(void) {
+    const char* name = "/c_unit_test_metrics_page";
+    metrics_page_t writer;
+    metrics_page_t reader;
+    metrics_snapshot_t snapshot;
+    queue_t queue;
+    int status;
+    
+    metrics_page_unlink(name);
+    assert(metrics_page_create(&writer, name) == true);
+    queue_init(&queue, 4);
+    assert(metrics_page_add_queue(&writer, "churn", &queue) == true);
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        task_manager_init();
+        publisher_loop(&writer, &queue);
+        _exit(0);
+    }
+    
+    // Every record read is internally consistent even though the child
+    // rewrites it continuously
+    assert(metrics_page_attach(&reader, name) == true);
+    uint32_t reads = 0;
+    uint64_t last_publish = 0;
+    for (uint32_t round = 0; round < READ_ROUNDS; round++) {
+        if (!metrics_page_read(&reader, &snapshot)) {
+            continue;
+        }
+        reads++;
+        uint32_t sum = 0;
+        for (uint32_t s = 0; s < TASK_STATE_COUNT; s++) {
+            sum += snapshot.tasks.per_state[s];
+        }
+        assert(sum == snapshot.tasks.count);
+        assert(snapshot.tasks.count <= 4);
+        assert(snapshot.queues[0].depth <= 4);
+        assert(strcmp(snapshot.queues[0].name, "churn") == 0);
+        assert(snapshot.publish_count >= last_publish);
+        last_publish = snapshot.publish_count;
+    }
+    
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+    assert(reads > 0);
+    
+    assert(metrics_page_unlink(name) == true);
+    assert(metrics_page_attach(&reader, "/c_unit_test_metrics_missing") == false);
+    metrics_page_detach(&reader);
+    metrics_page_detach(&writer);
+    
+    // A segment of the wrong size is not a metrics page
+    int fd = memfd_create("not_metrics", MFD_CLOEXEC);
+    assert(ftruncate(fd, 4096) == 0);
+    assert(metrics_page_attach_fd(&reader, fd) == false);
+    close(fd);
+    printf("✓ test_metrics_page_cross_process_consistency passed\n");
+}
+
+int main(void) {
+    printf("Running metrics page tests...\n");
+    
+    test_metrics_page_publish_and_read();
+    test_metrics_page_prometheus();
+    test_metrics_page_cross_process_consistency();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
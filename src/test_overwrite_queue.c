@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include "overwrite_queue.h"
+
+#define STRESS_ITEMS 200000u
+
+static overwrite_queue_t shared;
+static volatile bool producer_done = false;
+
+static void* producer_task(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < STRESS_ITEMS; i++) {
+        overwrite_queue_enqueue(&shared, (uint8_t)i);
+    }
+    __atomic_store_n(&producer_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Test cases
+void test_overwrite_queue_drops_oldest(void) {
+    overwrite_queue_t queue;
+    uint8_t item;
+    
+    overwrite_queue_init(&queue, 4);
+    for (uint8_t i = 1; i <= 6; i++) {
+        assert(overwrite_queue_enqueue(&queue, i) == true);
+    }
+    assert(overwrite_queue_size(&queue) == 4);
+    assert(overwrite_queue_dropped(&queue) == 2);
+    
+    for (uint8_t expected = 3; expected <= 6; expected++) {
+        assert(overwrite_queue_dequeue(&queue, &item) == true && item == expected);
+    }
+    assert(overwrite_queue_dequeue(&queue, &item) == false);
+    
+    printf("✓ test_overwrite_queue_drops_oldest passed\n");
+}
+
+void test_overwrite_queue_concurrent_reader(void) {
+    pthread_t thread;
+    uint8_t item;
+    uint8_t last = 0;
+    uint32_t received = 0;
+    
+    overwrite_queue_init(&shared, 8);
+    pthread_create(&thread, NULL, producer_task, NULL);
+    while (!__atomic_load_n(&producer_done, __ATOMIC_ACQUIRE) ||
+           overwrite_queue_size(&shared) > 0) {
+        if (overwrite_queue_dequeue(&shared, &item)) {
+            last = item;
+            received++;
+        }
+    }
+    pthread_join(thread, NULL);
+    
+    // Newest item always survives; everything else was received or dropped
+    assert(last == (uint8_t)(STRESS_ITEMS - 1));
+    assert(received + overwrite_queue_dropped(&shared) == STRESS_ITEMS);
+    
+    printf("✓ test_overwrite_queue_concurrent_reader passed\n");
+}
+
+void test_overwrite_mailbox(void) {
+    overwrite_mailbox_t mailbox;
+    uint32_t value = 0;
+    
+    assert(overwrite_mailbox_init(&mailbox, sizeof(uint32_t)) == true);
+    assert(overwrite_mailbox_peek(&mailbox, &value) == false);
+    assert(overwrite_mailbox_receive(&mailbox, &value) == false);
+    
+    uint32_t sample = 10;
+    overwrite_mailbox_write(&mailbox, &sample);
+    sample = 11;
+    overwrite_mailbox_write(&mailbox, &sample);
+    assert(overwrite_mailbox_dropped(&mailbox) == 1);
+    
+    // Peek leaves the value in place, receive consumes it
+    assert(overwrite_mailbox_peek(&mailbox, &value) == true && value == 11);
+    assert(overwrite_mailbox_receive(&mailbox, &value) == true && value == 11);
+    assert(overwrite_mailbox_receive(&mailbox, &value) == false);
+    assert(overwrite_mailbox_peek(&mailbox, &value) == true && value == 11);
+    
+    sample = 12;
+    overwrite_mailbox_write(&mailbox, &sample);
+    assert(overwrite_mailbox_dropped(&mailbox) == 1);
+    
+    printf("✓ test_overwrite_mailbox passed\n");
+}
+
+int main(void) {
+    printf("Running overwrite queue tests...\n");
+    
+    test_overwrite_queue_drops_oldest();
+    test_overwrite_queue_concurrent_reader();
+    test_overwrite_mailbox();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <assert.h>
+#include "pqueue.h"
+
+// Test cases
+void test_pqueue_heap_order(void) {
+    pqueue_heap_t pq;
+    uint8_t item;
+    
+    pqueue_heap_init(&pq, 8);
+    assert(pqueue_heap_enqueue(&pq, 'a', 1) == true);
+    assert(pqueue_heap_enqueue(&pq, 'b', 5) == true);
+    assert(pqueue_heap_enqueue(&pq, 'c', 1) == true);
+    assert(pqueue_heap_enqueue(&pq, 'd', 5) == true);
+    assert(pqueue_heap_enqueue(&pq, 'e', 1000) == true);
+    assert(pqueue_heap_size(&pq) == 5);
+    
+    const char* expected = "ebdac";
+    for (int i = 0; expected[i]; i++) {
+        assert(pqueue_heap_dequeue(&pq, &item) == true && item == expected[i]);
+    }
+    assert(pqueue_heap_dequeue(&pq, &item) == false);
+    
+    printf("✓ test_pqueue_heap_order passed\n");
+}
+
+void test_pqueue_bitmap_order(void) {
+    pqueue_bitmap_t pq;
+    uint8_t item;
+    
+    pqueue_bitmap_init(&pq, 8);
+    assert(pqueue_bitmap_enqueue(&pq, 'a', 1) == true);
+    assert(pqueue_bitmap_enqueue(&pq, 'b', 5) == true);
+    assert(pqueue_bitmap_enqueue(&pq, 'c', 1) == true);
+    assert(pqueue_bitmap_enqueue(&pq, 'd', 5) == true);
+    assert(pqueue_bitmap_enqueue(&pq, 'e', 31) == true);
+    assert(pqueue_bitmap_enqueue(&pq, 'x', PQUEUE_LEVELS) == false);
+    assert(pqueue_bitmap_size(&pq) == 5);
+    
+    const char* expected = "ebdac";
+    for (int i = 0; expected[i]; i++) {
+        assert(pqueue_bitmap_dequeue(&pq, &item) == true && item == expected[i]);
+    }
+    assert(pqueue_bitmap_dequeue(&pq, &item) == false);
+    
+    printf("✓ test_pqueue_bitmap_order passed\n");
+}
+
+void test_pqueue_implementations_agree(void) {
+    pqueue_heap_t heap;
+    pqueue_bitmap_t bitmap;
+    uint8_t a, b;
+    uint32_t seed = 12345;
+    
+    pqueue_heap_init(&heap, PQUEUE_MAX_SIZE);
+    pqueue_bitmap_init(&bitmap, PQUEUE_MAX_SIZE);
+    
+    for (int i = 0; i < 10000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) % 3 != 0) {
+            uint32_t priority = (seed >> 8) % 8;
+            bool ok = pqueue_heap_enqueue(&heap, (uint8_t)i, priority);
+            assert(ok == pqueue_bitmap_enqueue(&bitmap, (uint8_t)i, priority));
+        } else {
+            bool ok = pqueue_heap_dequeue(&heap, &a);
+            assert(ok == pqueue_bitmap_dequeue(&bitmap, &b));
+            assert(!ok || a == b);
+        }
+        assert(pqueue_heap_size(&heap) == pqueue_bitmap_size(&bitmap));
+    }
+    assert(pqueue_heap_is_full(&heap) == pqueue_bitmap_is_full(&bitmap));
+    
+    printf("✓ test_pqueue_implementations_agree passed\n");
+}
+
+int main(void) {
+    printf("Running priority queue tests...\n");
+    
+    test_pqueue_heap_order();
+    test_pqueue_bitmap_order();
+    test_pqueue_implementations_agree();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
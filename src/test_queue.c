@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "queue.h"
+
+// Test cases
+void test_queue_basic(void) {
+    queue_t queue;
+    uint8_t item;
+    
+    queue_init(&queue, 4);
+    assert(queue_is_empty(&queue));
+    assert(queue_enqueue(&queue, 1) == true);
+    assert(queue_enqueue(&queue, 2) == true);
+    assert(queue_size(&queue) == 2);
+    assert(queue_dequeue(&queue, &item) == true && item == 1);
+    assert(queue_dequeue(&queue, &item) == true && item == 2);
+    assert(queue_dequeue(&queue, &item) == false);
+    
+    printf("✓ test_queue_basic passed\n");
+}
+
+void test_queue_reserve_commit(void) {
+    queue_t queue;
+    uint8_t item;
+    
+    queue_init(&queue, 8);
+    
+    // Build records directly in ring memory
+    queue_span_t span = queue_reserve(&queue, 5);
+    assert(span.len == 5);
+    memcpy(span.data, "hello", 5);
+    assert(queue_commit(&queue, 5) == true);
+    assert(queue_size(&queue) == 5);
+    
+    // Cannot commit more than was free
+    assert(queue_commit(&queue, 4) == false);
+    
+    span = queue_read_acquire(&queue, 3);
+    assert(span.len == 3);
+    assert(memcmp(span.data, "hel", 3) == 0);
+    assert(queue_read_release(&queue, 3) == true);
+    assert(queue_dequeue(&queue, &item) == true && item == 'l');
+    
+    printf("✓ test_queue_reserve_commit passed\n");
+}
+
+void test_queue_span_wrap(void) {
+    queue_t queue;
+    
+    queue_init(&queue, 8);
+    queue_commit(&queue, queue_reserve(&queue, 6).len);
+    queue_read_release(&queue, queue_read_acquire(&queue, 6).len);
+    
+    // head == tail == 6: only two bytes before the wrap point
+    queue_span_t span = queue_reserve(&queue, 5);
+    assert(span.len == 2);
+    memcpy(span.data, "ab", 2);
+    assert(queue_commit(&queue, 2) == true);
+    span = queue_reserve(&queue, 3);
+    assert(span.len == 3 && span.data == queue.data);
+    memcpy(span.data, "cde", 3);
+    assert(queue_commit(&queue, 3) == true);
+    
+    span = queue_read_acquire(&queue, 5);
+    assert(span.len == 2 && memcmp(span.data, "ab", 2) == 0);
+    assert(queue_read_release(&queue, 2) == true);
+    span = queue_read_acquire(&queue, 5);
+    assert(span.len == 3 && memcmp(span.data, "cde", 3) == 0);
+    assert(queue_read_release(&queue, 3) == true);
+    assert(queue_is_empty(&queue));
+    
+    // Full and empty queues hand out empty spans
+    assert(queue_read_acquire(&queue, 1).len == 0);
+    queue_commit(&queue, queue_reserve(&queue, 8).len);
+    assert(queue_size(&queue) == 5);
+    queue_commit(&queue, queue_reserve(&queue, 8).len);
+    assert(queue_is_full(&queue));
+    assert(queue_reserve(&queue, 1).len == 0);
+    
+    printf("✓ test_queue_span_wrap passed\n");
+}
+
+void test_queue_bulk(void) {
+    queue_t queue;
+    uint8_t out[8];
+    
+    queue_init(&queue, 6);
+    assert(queue_enqueue_bulk(&queue, (const uint8_t*)"abcd", 4) == 4);
+    assert(queue_dequeue_bulk(&queue, out, 3) == 3);
+    
+    // Wraps: only 5 of 6 fit
+    assert(queue_enqueue_bulk(&queue, (const uint8_t*)"efghij", 6) == 5);
+    assert(queue_is_full(&queue));
+    assert(queue_dequeue_bulk(&queue, out, sizeof(out)) == 6);
+    assert(memcmp(out, "defghi", 6) == 0);
+    assert(queue_dequeue_bulk(&queue, out, sizeof(out)) == 0);
+    
+    printf("✓ test_queue_bulk passed\n");
+}
+
+void test_queue_stats(void) {
+    queue_t queue;
+    queue_stats_t stats;
+    uint8_t item;
+    
+    queue_init(&queue, 4);
+#ifdef QUEUE_STATS
+    for (uint8_t i = 0; i < 5; i++) {
+        queue_enqueue(&queue, i);
+    }
+    queue_dequeue(&queue, &item);
+    queue_commit(&queue, queue_reserve(&queue, 1).len);
+    while (queue_dequeue(&queue, &item)) {
+    }
+    
+    assert(queue_get_stats(&queue, &stats) == true);
+    assert(stats.high_watermark == 4);
+    assert(stats.enqueued == 5);
+    assert(stats.dequeued == 5);
+    assert(stats.full_failures == 1);
+    assert(stats.empty_failures == 1);
+    
+    uint64_t dwell_samples = 0;
+    for (uint32_t b = 0; b < QUEUE_STATS_BUCKETS; b++) {
+        dwell_samples += stats.dwell_histogram[b];
+    }
+    assert(dwell_samples == 5);
+    
+    queue_reset_stats(&queue);
+    assert(queue_get_stats(&queue, &stats) == true && stats.enqueued == 0);
+#else
+    (void)item;
+    assert(queue_get_stats(&queue, &stats) == false);
+#endif
+    
+    printf("✓ test_queue_stats passed\n");
+}
+
+int main(void) {
+    printf("Running queue tests...\n");
+    
+    test_queue_basic();
+    test_queue_reserve_commit();
+    test_queue_span_wrap();
+    test_queue_bulk();
+    test_queue_stats();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+#include "queue_set.h"
+
+static queue_set_t set;
+static blocking_queue_t queues[3];
+
+static void* producer_task(void* arg) {
+    (void)arg;
+    blocking_queue_send(&queues[2], 99, QUEUE_WAIT_FOREVER);
+    return NULL;
+}
+
+// Test cases
+void test_queue_set_select_order(void) {
+    uint8_t item;
+    
+    assert(queue_set_init(&set) == true);
+    for (int i = 0; i < 3; i++) {
+        blocking_queue_init(&queues[i], 4);
+        assert(queue_set_add(&set, &queues[i]) == true);
+    }
+    
+    // A queue can only be in one set at a time
+    assert(queue_set_add(&set, &queues[0]) == false);
+    assert(queue_set_select(&set, QUEUE_NO_WAIT) == NULL);
+    
+    blocking_queue_send(&queues[1], 10, QUEUE_NO_WAIT);
+    blocking_queue_send(&queues[0], 20, QUEUE_NO_WAIT);
+    blocking_queue_send(&queues[1], 11, QUEUE_NO_WAIT);
+    
+    // Non-empty members cannot leave the set, nor be drained in batches
+    uint8_t batch[4];
+    assert(queue_set_remove(&set, &queues[1]) == false);
+    assert(blocking_queue_receive_batch(&queues[1], batch, sizeof(batch)) == 0);
+    
+    blocking_queue_t* ready = queue_set_select(&set, QUEUE_NO_WAIT);
+    assert(ready == &queues[1]);
+    assert(blocking_queue_receive(ready, &item, QUEUE_NO_WAIT) && item == 10);
+    ready = queue_set_select(&set, QUEUE_NO_WAIT);
+    assert(ready == &queues[0]);
+    assert(blocking_queue_receive(ready, &item, QUEUE_NO_WAIT) && item == 20);
+    ready = queue_set_select(&set, QUEUE_NO_WAIT);
+    assert(ready == &queues[1]);
+    assert(blocking_queue_receive(ready, &item, QUEUE_NO_WAIT) && item == 11);
+    assert(queue_set_select(&set, 5) == NULL);
+    
+    printf("✓ test_queue_set_select_order passed\n");
+}
+
+void test_queue_set_wakes_selector(void) {
+    pthread_t thread;
+    uint8_t item;
+    
+    pthread_create(&thread, NULL, producer_task, NULL);
+    blocking_queue_t* ready = queue_set_select(&set, QUEUE_WAIT_FOREVER);
+    pthread_join(thread, NULL);
+    assert(ready == &queues[2]);
+    assert(blocking_queue_receive(ready, &item, QUEUE_NO_WAIT) && item == 99);
+    
+    for (int i = 0; i < 3; i++) {
+        assert(queue_set_remove(&set, &queues[i]) == true);
+        blocking_queue_destroy(&queues[i]);
+    }
+    queue_set_destroy(&set);
+    printf("✓ test_queue_set_wakes_selector passed\n");
+}
+
+int main(void) {
+    printf("Running queue set tests...\n");
+    
+    test_queue_set_select_order();
+    test_queue_set_wakes_selector();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <assert.h>
+#include <time.h>
+#include "sched_latency.h"
+#include "task_manager.h"
+
+#define SLACK_NS 1000000u   // tick calibration error over the sleeps
+
+typedef struct {
+    uint32_t calls;
+    uint32_t task_id;
+    uint64_t latency_ns;
+} alarm_log_t;
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec ts = { 0, (long)ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void on_alarm(uint32_t task_id, uint32_t priority, uint64_t latency_ns, void* arg) {
+    alarm_log_t* log = arg;
+    (void)priority;
+    // Runs outside the task lock, so the task manager is usable here
+    assert(task_get(task_id) != NULL);
+    log->calls++;
+    log->task_id = task_id;
+    log->latency_ns = latency_ns;
+}
+
+// True if value is within the histogram's relative error of expected
+static bool near(uint64_t value, uint64_t expected) {
+    uint64_t error = expected / SCHED_LATENCY_SUB_BUCKETS + 1;
+    return value + error >= expected && value <= expected + error;
+}
+
+// Test cases
+void test_sched_latency_percentiles(void) {
+    sched_latency_report_t report;
+    
+    sched_latency_reset();
+    for (uint64_t ns = 1; ns <= 100000; ns++) {
+        assert(sched_latency_record(3, ns) == false);
+    }
+    assert(sched_latency_get(3, &report) == true);
+    assert(report.count == 100000);
+    assert(report.max_ns == 100000);
+    assert(near(report.p50_ns, 50000));
+    assert(near(report.p99_ns, 99000));
+    assert(near(report.p999_ns, 99900));
+    assert(report.p999_ns <= report.max_ns);
+    assert(near(sched_latency_percentile(3, 25.0), 25000));
+    assert(sched_latency_percentile(3, 100.0) == 100000);
+    assert(sched_latency_percentile(3, 0.0) == 0);
+    
+    // Small values are exact, huge ones land in the last bucket
+    sched_latency_record(4, 7);
+    assert(sched_latency_percentile(4, 50.0) == 7);
+    sched_latency_record(5, UINT64_MAX);
+    assert(sched_latency_percentile(5, 50.0) == UINT64_MAX);
+    
+    // Priorities past the last level share it
+    sched_latency_record(SCHED_LATENCY_PRIORITIES + 10, 42);
+    assert(sched_latency_get(SCHED_LATENCY_PRIORITIES - 1, &report) == true);
+    assert(report.count == 1 && report.max_ns == 42 && report.sum_ns == 42);
+    
+    assert(sched_latency_get(6, &report) == true);
+    assert(report.count == 0 && report.p50_ns == 0);
+    assert(sched_latency_get(3, NULL) == false);
+    printf("✓ test_sched_latency_percentiles passed\n");
+}
+
+void test_sched_latency_ready_to_running(void) {
+    sched_latency_report_t report;
+    
+    task_manager_init();
+    assert(task_create(1, "Waker", 2, 0) == true);
+    sleep_ms(10);
+    assert(task_set_state(1, TASK_RUNNING) == true);
+    
+    // Only READY -> RUNNING is measured
+    assert(task_set_state(1, TASK_BLOCKED) == true);
+    assert(task_set_state(1, TASK_RUNNING) == true);
+    assert(task_set_state(1, TASK_READY) == true);
+    sleep_ms(5);
+    // Setting READY again does not restart the wait
+    assert(task_set_state(1, TASK_READY) == true);
+    sleep_ms(5);
+    assert(task_set_state(1, TASK_RUNNING) == true);
+    
+    assert(sched_latency_get(2, &report) == true);
+    assert(report.count == 2);
+    assert(report.max_ns + SLACK_NS >= 10000000u);
+    assert(report.p50_ns + SLACK_NS >= 10000000u);
+    assert(sched_latency_get(1, &report) == true);
+    assert(report.count == 0);
+    
+    task_manager_init();
+    assert(sched_latency_get(2, &report) == true);
+    assert(report.count == 0);
+    printf("✓ test_sched_latency_ready_to_running passed\n");
+}
+
+void test_sched_latency_alarm(void) {
+    sched_latency_report_t report;
+    alarm_log_t log = { 0, 0, 0 };
+    
+    task_manager_init();
+    assert(sched_latency_set_alarm(4, 2000000u, on_alarm, &log) == true);
+    assert(task_create(7, "Fast", 4, 0) == true);
+    assert(task_create(8, "Late", 4, 0) == true);
+    assert(task_set_state(7, TASK_RUNNING) == true);
+    sleep_ms(5);
+    assert(task_set_state(8, TASK_RUNNING) == true);
+    
+    assert(log.calls == 1);
+    assert(log.task_id == 8);
+    assert(log.latency_ns > 2000000u);
+    assert(sched_latency_get(4, &report) == true);
+    assert(report.count == 2);
+    assert(report.alarms == 1);
+    
+    // Threshold 0 turns the alarm off
+    assert(sched_latency_set_alarm(4, 0, on_alarm, &log) == true);
+    assert(task_set_state(8, TASK_READY) == true);
+    sleep_ms(5);
+    assert(task_set_state(8, TASK_RUNNING) == true);
+    assert(log.calls == 1);
+    
+    assert(sched_latency_set_alarm(SCHED_LATENCY_PRIORITIES, 1, NULL, NULL) == false);
+    task_manager_init();
+    printf("✓ test_sched_latency_alarm passed\n");
+}
+
+int main(void) {
+    printf("Running scheduling latency tests...\n");
+    
+    test_sched_latency_percentiles();
+    test_sched_latency_ready_to_running();
+    test_sched_latency_alarm();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
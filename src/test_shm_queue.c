@@ -0,0 +1,151 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <assert.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "shm_queue.h"
+
+#define SHM_TEST_ITEMS 10000u
+
+static void produce(shm_queue_t* q) {
+    for (uint32_t i = 0; i < SHM_TEST_ITEMS; i++) {
+        while (!shm_queue_enqueue(q, &i)) {
+            sched_yield();
+        }
+    }
+}
+
+static void consume(shm_queue_t* q) {
+    uint32_t value;
+    for (uint32_t i = 0; i < SHM_TEST_ITEMS; i++) {
+        while (!shm_queue_dequeue(q, &value)) {
+            sched_yield();
+        }
+        assert(value == i);
+    }
+}
+
+// Test cases
+void test_shm_queue_single_process(void) {
+    shm_queue_t q;
+    uint64_t value;
+    
+    assert(shm_queue_create(&q, NULL, 3, sizeof(value)) == false);
+    assert(shm_queue_create(&q, NULL, 4, sizeof(value)) == true);
+    for (value = 0; value < 4; value++) {
+        assert(shm_queue_enqueue(&q, &value) == true);
+    }
+    assert(shm_queue_enqueue(&q, &value) == false);
+    assert(shm_queue_size(&q) == 4);
+    assert(shm_queue_dequeue(&q, &value) == true && value == 0);
+    shm_queue_detach(&q);
+    
+    printf("✓ test_shm_queue_single_process passed\n");
+}
+
+void test_shm_queue_named_cross_process(void) {
+    const char* name = "/c_unit_test_shm_queue";
+    shm_queue_t q;
+    int status;
+    
+    shm_queue_unlink(name);
+    assert(shm_queue_create(&q, name, 64, sizeof(uint32_t)) == true);
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        shm_queue_t child;
+        if (!shm_queue_attach(&child, name)) {
+            _exit(1);
+        }
+        produce(&child);
+        shm_queue_detach(&child);
+        _exit(0);
+    }
+    
+    consume(&q);
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    
+    shm_queue_detach(&q);
+    assert(shm_queue_unlink(name) == true);
+    printf("✓ test_shm_queue_named_cross_process passed\n");
+}
+
+void test_shm_queue_memfd_cross_process(void) {
+    shm_queue_t q;
+    int status;
+    
+    assert(shm_queue_create(&q, NULL, 16, sizeof(uint32_t)) == true);
+    
+    // The child inherits the memfd and maps it at its own address
+    int fd = dup(q.fd);
+    pid_t pid = fork();
+    if (pid == 0) {
+        shm_queue_t child;
+        if (!shm_queue_attach_fd(&child, fd)) {
+            _exit(1);
+        }
+        consume(&child);
+        _exit(0);
+    }
+    close(fd);
+    
+    produce(&q);
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    
+    shm_queue_detach(&q);
+    printf("✓ test_shm_queue_memfd_cross_process passed\n");
+}
+
+void test_shm_queue_untrusted_header(void) {
+    shm_queue_t owner;
+    shm_queue_t peer;
+    uint64_t value = 7;
+    
+    assert(shm_queue_create(&owner, NULL, 4, sizeof(value)) == true);
+    shm_queue_header_t* header = owner.header;
+    
+    // Geometry that does not fit a mask or the mapping is rejected
+    uint32_t bad_capacities[] = { 0, 3, 1u << 20 };
+    int fd = dup(owner.fd);
+    for (uint32_t i = 0; i < 3; i++) {
+        header->capacity = bad_capacities[i];
+        assert(shm_queue_attach_fd(&peer, fd) == false);
+    }
+    header->capacity = 4;
+    header->data_offset = 0;
+    assert(shm_queue_attach_fd(&peer, fd) == false);
+    close(fd);
+    header->data_offset = owner.data - (uint8_t*)header;
+    
+    // Once attached, later header changes by the other side are ignored
+    assert(shm_queue_attach_fd(&peer, dup(owner.fd)) == true);
+    header->capacity = 1u << 31;
+    header->elem_size = 1u << 30;
+    header->map_size = 1;
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(shm_queue_enqueue(&peer, &value) == true);
+    }
+    assert(shm_queue_enqueue(&peer, &value) == false);
+    assert(shm_queue_size(&peer) == 4);
+    assert(shm_queue_dequeue(&owner, &value) == true && value == 7);
+    shm_queue_detach(&peer);
+    shm_queue_detach(&owner);
+    
+    printf("✓ test_shm_queue_untrusted_header passed\n");
+}
+
+int main(void) {
+    printf("Running shared memory queue tests...\n");
+    
+    test_shm_queue_single_process();
+    test_shm_queue_untrusted_header();
+    test_shm_queue_named_cross_process();
+    test_shm_queue_memfd_cross_process();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
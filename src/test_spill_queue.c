@@ -0,0 +1,116 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <dirent.h>
+#include <unistd.h>
+#include "spill_queue.h"
+
+static uint32_t count_files(const char* dir) {
+    uint32_t files = 0;
+    DIR* d = opendir(dir);
+    struct dirent* entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (entry->d_name[0] != '.') {
+            files++;
+        }
+    }
+    closedir(d);
+    return files;
+}
+
+// Test cases
+void test_spill_queue_keeps_order(void) {
+    char dir[] = "/tmp/spill_test_XXXXXX";
+    spill_queue_t sq;
+    uint8_t item;
+    
+    assert(mkdtemp(dir) != NULL);
+    assert(spill_queue_init(&sq, 4, dir, 64) == true);
+    
+    // Burst far beyond the ring: 5000 items over many 64-byte segments
+    for (uint32_t i = 0; i < 5000; i++) {
+        assert(spill_queue_enqueue(&sq, (uint8_t)i) == true);
+    }
+    assert(spill_queue_size(&sq) == 5000);
+    assert(spill_queue_spilled(&sq) == 5000 - 4);
+    assert(count_files(dir) > 1);
+    
+    // Interleave draining with new items; order must be preserved
+    for (uint32_t i = 0; i < 2500; i++) {
+        assert(spill_queue_dequeue(&sq, &item) == true && item == (uint8_t)i);
+    }
+    for (uint32_t i = 5000; i < 6000; i++) {
+        assert(spill_queue_enqueue(&sq, (uint8_t)i) == true);
+    }
+    for (uint32_t i = 2500; i < 6000; i++) {
+        assert(spill_queue_dequeue(&sq, &item) == true && item == (uint8_t)i);
+    }
+    assert(spill_queue_dequeue(&sq, &item) == false);
+    assert(spill_queue_spilled(&sq) == 0);
+    
+    // Back on the in-memory fast path
+    assert(spill_queue_enqueue(&sq, 1) == true);
+    assert(spill_queue_spilled(&sq) == 0);
+    
+    spill_queue_destroy(&sq);
+    assert(count_files(dir) == 0);
+    rmdir(dir);
+    printf("✓ test_spill_queue_keeps_order passed\n");
+}
+
+void test_spill_queue_destroy_removes_backlog(void) {
+    char dir[] = "/tmp/spill_test_XXXXXX";
+    spill_queue_t sq;
+    
+    assert(mkdtemp(dir) != NULL);
+    assert(spill_queue_init(&sq, 2, dir, 32) == true);
+    for (uint32_t i = 0; i < 200; i++) {
+        spill_queue_enqueue(&sq, (uint8_t)i);
+    }
+    assert(count_files(dir) > 1);
+    
+    spill_queue_destroy(&sq);
+    assert(count_files(dir) == 0);
+    assert(rmdir(dir) == 0);
+    printf("✓ test_spill_queue_destroy_removes_backlog passed\n");
+}
+
+void test_spill_queue_shared_dir(void) {
+    char dir[] = "/tmp/spill_test_XXXXXX";
+    spill_queue_t a;
+    spill_queue_t b;
+    uint8_t item;
+    
+    assert(mkdtemp(dir) != NULL);
+    assert(spill_queue_init(&a, 2, dir, 32) == true);
+    assert(spill_queue_init(&b, 2, dir, 32) == true);
+    
+    // Both spill into the same directory without touching each other
+    for (uint32_t i = 0; i < 200; i++) {
+        assert(spill_queue_enqueue(&a, (uint8_t)i) == true);
+        assert(spill_queue_enqueue(&b, (uint8_t)(255 - i)) == true);
+    }
+    uint32_t both = count_files(dir);
+    spill_queue_destroy(&a);
+    assert(count_files(dir) > 0 && count_files(dir) < both);
+    for (uint32_t i = 0; i < 200; i++) {
+        assert(spill_queue_dequeue(&b, &item) == true && item == (uint8_t)(255 - i));
+    }
+    spill_queue_destroy(&b);
+    assert(count_files(dir) == 0);
+    assert(rmdir(dir) == 0);
+    printf("✓ test_spill_queue_shared_dir passed\n");
+}
+
+int main(void) {
+    printf("Running spill queue tests...\n");
+    
+    test_spill_queue_keeps_order();
+    test_spill_queue_destroy_removes_backlog();
+    test_spill_queue_shared_dir();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
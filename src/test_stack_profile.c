@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include "stack_profile.h"
+#include "green_thread.h"
+#include "task_manager.h"
+
+#define BUFFER_SIZE 1024
+#define DEEP_BYTES  1500
+
+static uint8_t buffer[BUFFER_SIZE + 16];
+
+// Byte-at-a-time reference for the vectorized scan
+static uint32_t naive_unused(const uint8_t* stack, uint32_t size) {
+    uint32_t n = 0;
+    while (n < size && stack[n] == STACK_FILL_BYTE) {
+        n++;
+    }
+    return n;
+}
+
+static green_sched_t sched;
+
+static void deep_task(void* arg) {
+    (void)arg;
+    volatile uint8_t scratch[DEEP_BYTES];
+    for (uint32_t i = 0; i < sizeof(scratch); i++) {
+        scratch[i] = 0;
+    }
+    // Parked so its stack can be inspected before it is deleted
+    green_block();
+}
+
+// Test cases
+void test_stack_scan_matches_reference(void) {
+    // Every alignment of the buffer start and of the first touched byte
+    for (uint32_t offset = 0; offset < 16; offset++) {
+        uint8_t* stack = buffer + offset;
+        for (uint32_t touched = 0; touched <= BUFFER_SIZE; touched += 7) {
+            stack_paint(stack, BUFFER_SIZE);
+            if (touched < BUFFER_SIZE) {
+                stack[touched] = 0;
+            }
+            assert(stack_unused_bytes(stack, BUFFER_SIZE) == naive_unused(stack, BUFFER_SIZE));
+            assert(stack_unused_bytes(stack, BUFFER_SIZE) == touched);
+        }
+    }
+    // Sizes that are not a multiple of the scan block
+    stack_paint(buffer, 13);
+    assert(stack_unused_bytes(buffer, 13) == 13);
+    assert(stack_unused_bytes(NULL, 64) == 0);
+    printf("✓ test_stack_scan_matches_reference passed\n");
+}
+
+void test_stack_recommend_size(void) {
+    // Small stacks get the minimum margin, then the green thread minimum
+    assert(stack_recommend_size(0) == STACK_MIN_SIZE);
+    assert(stack_recommend_size(1000) == 1264);
+    assert(stack_recommend_size(4000) == 5008);
+    assert(stack_recommend_size(4000) % STACK_ALIGN == 0);
+    printf("✓ test_stack_recommend_size passed\n");
+}
+
+void test_task_stack_painted_at_create(void) {
+    task_manager_init();
+    assert(task_create(1, "Painted", 1, 2048) == true);
+    assert(task_get_stack_high_water_mark(1) == 2048);
+    
+    // Stacks grow down: touching the top leaves the far end painted
+    uint8_t* stack = task_get(1)->stack;
+    memset(stack + 2048 - 300, 0, 300);
+    assert(task_get_stack_high_water_mark(1) == 2048 - 300);
+    
+    assert(task_create(2, "NoStack", 1, 0) == true);
+    assert(task_get_stack_high_water_mark(2) == 0);
+    assert(task_get_stack_high_water_mark(99) == 0);
+    task_manager_init();
+    printf("✓ test_task_stack_painted_at_create passed\n");
+}
+
+void test_task_stack_report(void) {
+    green_task_t deep;
+    task_stack_report_t reports[4];
+    
+    assert(task_create(1, "Deep", 1, 4096) == true);
+    assert(task_create(2, "Idle", 1, 8192) == true);
+    assert(task_create(3, "NoStack", 1, 0) == true);
+    green_sched_init(&sched);
+    assert(green_spawn(&sched, &deep, 1, deep_task, NULL) == true);
+    green_sched_run(&sched);
+    
+    // Tasks without a stack are left out
+    assert(task_stack_report(reports, 4) == 2);
+    for (uint32_t i = 0; i < 2; i++) {
+        task_stack_report_t* report = &reports[i];
+        if (report->task_id == 1) {
+            assert(strcmp(report->name, "Deep") == 0);
+            assert(report->stack_size == 4096);
+            assert(report->peak_used >= DEEP_BYTES);
+            assert(report->peak_used < 4096);
+            assert(report->recommended > report->peak_used);
+            assert(report->recommended < 4096);
+        } else {
+            assert(report->task_id == 2);
+            assert(report->peak_used == 0);
+            assert(report->recommended == STACK_MIN_SIZE);
+        }
+    }
+    assert(task_stack_report(reports, 1) == 1);
+    assert(task_stack_report(NULL, 4) == 0);
+    
+    green_kill(&deep);
+    green_sched_destroy(&sched);
+    task_manager_init();
+    printf("✓ test_task_stack_report passed\n");
+}
+
+int main(void) {
+    printf("Running stack profile tests...\n");
+    
+    test_stack_scan_matches_reference();
+    test_stack_recommend_size();
+    test_task_stack_painted_at_create();
+    test_task_stack_report();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "stream_buffer.h"
+
+static uint8_t storage[64];
+static stream_buffer_t sb;
+
+static void* trickle_writer(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 8; i++) {
+        stream_buffer_send(&sb, "x", 1, QUEUE_WAIT_FOREVER);
+    }
+    return NULL;
+}
+
+// Test cases
+void test_stream_buffer_wrap(void) {
+    uint8_t out[32];
+    
+    assert(stream_buffer_init(&sb, storage, 16, 1) == true);
+    assert(stream_buffer_send(&sb, "0123456789", 10, QUEUE_NO_WAIT) == 10);
+    assert(stream_buffer_receive(&sb, out, 8, QUEUE_NO_WAIT) == 8);
+    assert(memcmp(out, "01234567", 8) == 0);
+    
+    // Crosses the end of storage; only the free space is written
+    assert(stream_buffer_send(&sb, "abcdefghijklmnop", 16, QUEUE_NO_WAIT) == 14);
+    assert(stream_buffer_spaces_available(&sb) == 0);
+    assert(stream_buffer_receive(&sb, out, sizeof(out), QUEUE_NO_WAIT) == 16);
+    assert(memcmp(out, "89abcdefghijklmn", 16) == 0);
+    
+    stream_buffer_destroy(&sb);
+    printf("✓ test_stream_buffer_wrap passed\n");
+}
+
+void test_stream_buffer_trigger_level(void) {
+    pthread_t thread;
+    uint8_t out[16];
+    
+    assert(stream_buffer_init(&sb, storage, sizeof(storage), 8) == true);
+    assert(stream_buffer_send(&sb, "abc", 3, QUEUE_NO_WAIT) == 3);
+    
+    // Below the trigger level a timed receive returns what is there
+    assert(stream_buffer_receive(&sb, out, sizeof(out), 5) == 3);
+    
+    pthread_create(&thread, NULL, trickle_writer, NULL);
+    assert(stream_buffer_receive(&sb, out, sizeof(out), QUEUE_WAIT_FOREVER) == 8);
+    pthread_join(thread, NULL);
+    
+    stream_buffer_destroy(&sb);
+    printf("✓ test_stream_buffer_trigger_level passed\n");
+}
+
+void test_message_buffer(void) {
+    message_buffer_t mb;
+    char out[32];
+    
+    assert(message_buffer_init(&mb, storage, 24) == true);
+    assert(stream_buffer_send(&mb, "raw", 3, QUEUE_NO_WAIT) == 0);
+    assert(message_buffer_send(&mb, "hello", 5, QUEUE_NO_WAIT) == 5);
+    assert(message_buffer_send(&mb, "framed!", 7, QUEUE_NO_WAIT) == 7);
+    
+    // Messages are all-or-nothing: 4 + 9 bytes do not fit in the 4 left
+    assert(message_buffer_send(&mb, "too long!", 9, QUEUE_NO_WAIT) == 0);
+    
+    // A receive buffer that is too small leaves the message in place
+    assert(message_buffer_receive(&mb, out, 4, QUEUE_NO_WAIT) == 0);
+    assert(message_buffer_receive(&mb, out, sizeof(out), QUEUE_NO_WAIT) == 5);
+    assert(memcmp(out, "hello", 5) == 0);
+    
+    // Wraps around the end of storage
+    assert(message_buffer_send(&mb, "wrapped", 7, QUEUE_NO_WAIT) == 7);
+    assert(message_buffer_receive(&mb, out, sizeof(out), QUEUE_NO_WAIT) == 7);
+    assert(memcmp(out, "framed!", 7) == 0);
+    assert(message_buffer_receive(&mb, out, sizeof(out), QUEUE_NO_WAIT) == 7);
+    assert(memcmp(out, "wrapped", 7) == 0);
+    assert(message_buffer_receive(&mb, out, sizeof(out), 5) == 0);
+    
+    // Every wrap position, including ones that split the length prefix
+    for (uint32_t i = 0; i < 48; i++) {
+        uint32_t len = i % 11;
+        assert(message_buffer_send(&mb, "0123456789", len, QUEUE_NO_WAIT) == len);
+        assert(message_buffer_receive(&mb, out, sizeof(out), QUEUE_NO_WAIT) == len);
+        assert(memcmp(out, "0123456789", len) == 0);
+    }
+    
+    message_buffer_destroy(&mb);
+    printf("✓ test_message_buffer passed\n");
+}
+
+int main(void) {
+    printf("Running stream buffer tests...\n");
+    
+    test_stream_buffer_wrap();
+    test_stream_buffer_trigger_level();
+    test_message_buffer();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,161 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "task_manager.h"
+#include "timestamp.h"
+
+#define CHURN_BASE_ID 100
+#define CHURN_TASKS   4
+#define DUMP_ROUNDS   2000
+#define SLACK_NS      1000000u   // tick calibration error over the sleeps
+
+static volatile bool churn_stop = false;
+
+static void sleep_ms(uint32_t ms) {
+    struct timespec ts = { 0, (long)ms * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// Creates, deletes and switches tasks while the main thread dumps stats
+static void* churn_thread(void* arg) {
+    (void)arg;
+    uint32_t round = 0;
+    while (!churn_stop) {
+        uint32_t id = CHURN_BASE_ID + round % CHURN_TASKS;
+        task_create(id, "Churn", 1, 0);
+        task_set_state(id, TASK_RUNNING);
+        task_set_state(1, (round & 1) ? TASK_READY : TASK_RUNNING);
+        task_delete(id);
+        round++;
+    }
+    return NULL;
+}
+
+// Test cases
+void test_task_stats_accounting(void) {
+    task_runtime_stats_t stats;
+    
+    task_manager_init();
+    assert(task_create(1, "Worker", 1, 0) == true);
+    uint64_t before_run = timestamp_now_ns();
+    assert(task_set_state(1, TASK_RUNNING) == true);
+    sleep_ms(20);
+    assert(task_set_state(1, TASK_BLOCKED) == true);
+    sleep_ms(10);
+    assert(task_set_state(1, TASK_BLOCKED) == true);
+    assert(task_set_state(1, TASK_READY) == true);
+    
+    assert(task_get_runtime_stats(1, &stats) == true);
+    assert(stats.task_id == 1);
+    assert(strcmp(stats.name, "Worker") == 0);
+    assert(stats.state == TASK_READY);
+    // Setting the state a task is already in is not a transition
+    assert(stats.transitions == 3);
+    assert(stats.time_in_state_ns[TASK_RUNNING] + SLACK_NS >= 20000000u);
+    assert(stats.time_in_state_ns[TASK_BLOCKED] + SLACK_NS >= 10000000u);
+    assert(stats.time_in_state_ns[TASK_SUSPENDED] == 0);
+    assert(stats.last_run_ns + SLACK_NS >= before_run);
+    assert(stats.last_run_ns <= timestamp_now_ns() + SLACK_NS);
+    
+    // The current state's time keeps growing between queries
+    uint64_t ready_ns = stats.time_in_state_ns[TASK_READY];
+    sleep_ms(5);
+    assert(task_get_runtime_stats(1, &stats) == true);
+    assert(stats.time_in_state_ns[TASK_READY] + SLACK_NS >= ready_ns + 5000000u);
+    
+    assert(task_get_runtime_stats(99, &stats) == false);
+    assert(task_get_runtime_stats(1, NULL) == false);
+    
+    // Out-of-range states are rejected and leave the task and its
+    // neighbours alone
+    assert(task_create(2, "Neighbour", 3, 0) == true);
+    assert(task_set_state(1, (task_state_t)TASK_STATE_COUNT) == false);
+    assert(task_set_state(1, (task_state_t)7) == false);
+    assert(task_set_state(1, TASK_RUNNING) == true);
+    assert(task_get(1)->state == TASK_RUNNING);
+    assert(task_get(2)->task_id == 2 && task_get(2)->priority == 3);
+    assert(task_delete(2) == true);
+    printf("✓ test_task_stats_accounting passed\n");
+}
+
+void test_task_stats_never_run(void) {
+    task_runtime_stats_t stats;
+    
+    assert(task_create(2, "Idle", 1, 0) == true);
+    assert(task_get_runtime_stats(2, &stats) == true);
+    assert(stats.last_run_ns == 0);
+    assert(stats.transitions == 0);
+    assert(task_delete(2) == true);
+    printf("✓ test_task_stats_never_run passed\n");
+}
+
+void test_task_stats_dump_all_under_churn(void) {
+    task_runtime_stats_t stats[MAX_TASKS];
+    pthread_t thread;
+    
+    assert(task_create(2, "Second", 1, 0) == true);
+    churn_stop = false;
+    assert(pthread_create(&thread, NULL, churn_thread, NULL) == 0);
+    
+    for (uint32_t round = 0; round < DUMP_ROUNDS; round++) {
+        uint32_t count = task_get_runtime_stats_all(stats, MAX_TASKS);
+        // Every dump is a consistent view: the fixed tasks plus at most
+        // one churn task, never a torn or duplicated record
+        assert(count >= 2 && count <= 3);
+        bool seen[2] = { false, false };
+        for (uint32_t i = 0; i < count; i++) {
+            if (stats[i].task_id == 1 || stats[i].task_id == 2) {
+                assert(!seen[stats[i].task_id - 1]);
+                seen[stats[i].task_id - 1] = true;
+            } else {
+                assert(stats[i].task_id >= CHURN_BASE_ID);
+                assert(stats[i].task_id < CHURN_BASE_ID + CHURN_TASKS);
+                assert(strcmp(stats[i].name, "Churn") == 0);
+            }
+        }
+        assert(seen[0] && seen[1]);
+        if ((round & 63) == 0) {
+            sched_yield();
+        }
+    }
+    
+    churn_stop = true;
+    pthread_join(thread, NULL);
+    assert(task_get_runtime_stats_all(stats, 1) == 1);
+    assert(task_get_runtime_stats_all(NULL, MAX_TASKS) == 0);
+    task_manager_init();
+    printf("✓ test_task_stats_dump_all_under_churn passed\n");
+}
+
+void test_timestamp_scale_ticks(void) {
+    // Matches a full 128-bit multiply, including products past 2^64
+    const uint64_t ticks[] = { 0, 1, 3000000000u, 0x123456789abcdefull, UINT64_MAX >> 8 };
+    const uint64_t scales[] = { 1ull << 32, 0x5555555u, 0x1a2b3c4d5ull };
+    for (uint32_t i = 0; i < sizeof(ticks) / sizeof(ticks[0]); i++) {
+        for (uint32_t j = 0; j < sizeof(scales) / sizeof(scales[0]); j++) {
+#ifdef __SIZEOF_INT128__
+            uint64_t expected = (uint64_t)(((unsigned __int128)ticks[i] * scales[j]) >> 32);
+            assert(timestamp_scale_ticks(ticks[i], scales[j]) == expected);
+#endif
+        }
+    }
+    assert(timestamp_scale_ticks(12345, 1ull << 32) == 12345);
+    assert(timestamp_scale_ticks(3, 1ull << 31) == 1);
+    printf("✓ test_timestamp_scale_ticks passed\n");
+}
+
+int main(void) {
+    printf("Running task statistics tests...\n");
+    
+    test_task_stats_accounting();
+    test_task_stats_never_run();
+    test_task_stats_dump_all_under_churn();
+    test_timestamp_scale_ticks();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,217 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "trace.h"
+#include "task_manager.h"
+#include "queue.h"
+
+#define OTHER_THREAD_EVENTS 100
+
+typedef struct {
+    uint32_t rings;
+    uint32_t records;
+    trace_record_t last;
+} dump_summary_t;
+
+static char trace_path[64];
+
+// Reads back a trace_dump file: ring count, total records, last record
+static dump_summary_t read_dump(const char* path) {
+    dump_summary_t summary;
+    memset(&summary, 0, sizeof(summary));
+    FILE* file = fopen(path, "rb");
+    assert(file != NULL);
+    
+    uint32_t header[6];
+    assert(fread(header, sizeof(header), 1, file) == 1);
+    assert(header[0] == TRACE_MAGIC);
+    assert(header[1] == TRACE_VERSION);
+    summary.rings = header[4];
+    for (uint32_t r = 0; r < summary.rings; r++) {
+        uint32_t ring[2];
+        assert(fread(ring, sizeof(ring), 1, file) == 1);
+        for (uint32_t i = 0; i < ring[1]; i++) {
+            assert(fread(&summary.last, sizeof(trace_record_t), 1, file) == 1);
+        }
+        summary.records += ring[1];
+    }
+    fclose(file);
+    return summary;
+}
+
+// Exports the dump and returns the JSON text; the caller frees it
+static char* export_json(void) {
+    FILE* out = tmpfile();
+    assert(out != NULL);
+    assert(trace_export_chrome(trace_path, out) == true);
+    long size = ftell(out);
+    char* json = malloc((size_t)size + 1);
+    rewind(out);
+    assert(fread(json, 1, (size_t)size, out) == (size_t)size);
+    json[size] = '\0';
+    fclose(out);
+    return json;
+}
+
+static uint32_t count_matches(const char* text, const char* pattern) {
+    uint32_t n = 0;
+    for (const char* p = strstr(text, pattern); p; p = strstr(p + 1, pattern)) {
+        n++;
+    }
+    return n;
+}
+
+static void* other_thread(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < OTHER_THREAD_EVENTS; i++) {
+        trace_record(TRACE_QUEUE_ENQUEUE, 0x1000, i);
+    }
+    return NULL;
+}
+
+// Test cases
+void test_trace_per_thread_rings(void) {
+    pthread_t thread;
+    
+    trace_clear();
+    trace_record(TRACE_TASK_CREATE, 1, 3);
+    trace_record(TRACE_TASK_STATE, 1, TASK_RUNNING);
+    assert(pthread_create(&thread, NULL, other_thread, NULL) == 0);
+    pthread_join(thread, NULL);
+    
+    // The exited thread's ring is still dumped
+    assert(trace_dump(trace_path) == true);
+    dump_summary_t summary = read_dump(trace_path);
+    assert(summary.rings == 2);
+    assert(summary.records == 2 + OTHER_THREAD_EVENTS);
+    assert(trace_dump(NULL) == false);
+    printf("✓ test_trace_per_thread_rings passed\n");
+}
+
+void test_trace_reuses_exited_thread_rings(void) {
+    pthread_t thread;
+    
+    // The previous test dumped the exited thread's ring, so it is reused
+    trace_clear();
+    assert(pthread_create(&thread, NULL, other_thread, NULL) == 0);
+    pthread_join(thread, NULL);
+    assert(pthread_create(&thread, NULL, other_thread, NULL) == 0);
+    pthread_join(thread, NULL);
+    
+    // The first of these has not been dumped yet, so the second thread
+    // needed a ring of its own
+    assert(trace_dump(trace_path) == true);
+    dump_summary_t summary = read_dump(trace_path);
+    assert(summary.rings == 3);
+    assert(summary.records == 2 * OTHER_THREAD_EVENTS);
+    
+    // Both were freed by that dump: later threads take them over and the
+    // next dump holds only their history
+    for (int i = 0; i < 4; i++) {
+        assert(pthread_create(&thread, NULL, other_thread, NULL) == 0);
+        pthread_join(thread, NULL);
+        assert(trace_dump(trace_path) == true);
+        summary = read_dump(trace_path);
+        assert(summary.rings == 2);
+        assert(summary.records == OTHER_THREAD_EVENTS);
+    }
+    assert(trace_dump(trace_path) == true);
+    assert(read_dump(trace_path).rings == 1);
+    printf("✓ test_trace_reuses_exited_thread_rings passed\n");
+}
+
+void test_trace_ring_overwrites_oldest(void) {
+    trace_clear();
+    for (uint32_t i = 0; i < TRACE_RING_RECORDS + 100; i++) {
+        trace_record(TRACE_TASK_STATE, 7, i);
+    }
+    assert(trace_dump(trace_path) == true);
+    dump_summary_t summary = read_dump(trace_path);
+    
+    // The newest records survive; the slot the writer would reuse next
+    // is left out of the dump
+    assert(summary.records == TRACE_RING_RECORDS - 1);
+    assert(summary.last.value == TRACE_RING_RECORDS + 99);
+    assert(summary.last.object == 7);
+    printf("✓ test_trace_ring_overwrites_oldest passed\n");
+}
+
+void test_trace_export_chrome(void) {
+    trace_clear();
+    trace_record(TRACE_TASK_CREATE, 5, 2);
+    trace_record(TRACE_TASK_STATE, 5, TASK_RUNNING);
+    trace_record(TRACE_TASK_STATE, 5, TASK_RUNNING);
+    trace_record(TRACE_QUEUE_ENQUEUE, 0xabc0, 1);
+    trace_record(TRACE_TASK_STATE, 5, TASK_BLOCKED);
+    trace_record(TRACE_QUEUE_DEQUEUE, 0xabc0, 0);
+    trace_record(TRACE_TASK_DELETE, 5, 0);
+    trace_record(TRACE_TASK_STATE, 6, TASK_RUNNING);
+    assert(trace_dump(trace_path) == true);
+    
+    char* json = export_json();
+    assert(strncmp(json, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 38) == 0);
+    assert(strcmp(json + strlen(json) - 4, "\n]}\n") == 0);
+    assert(count_matches(json, "\"name\":\"task 5\"") == 1);
+    assert(count_matches(json, "\"name\":\"task 6\"") == 1);
+    
+    // Task 5: READY, RUNNING (set twice, one span), BLOCKED, then deleted.
+    // Task 6 appears mid-trace and stays RUNNING to the end.
+    assert(count_matches(json, "\"name\":\"READY\",\"ph\":\"X\",\"pid\":1,\"tid\":5") == 1);
+    assert(count_matches(json, "\"name\":\"RUNNING\",\"ph\":\"X\",\"pid\":1,\"tid\":5") == 1);
+    assert(count_matches(json, "\"name\":\"BLOCKED\",\"ph\":\"X\",\"pid\":1,\"tid\":5") == 1);
+    assert(count_matches(json, "\"name\":\"RUNNING\",\"ph\":\"X\",\"pid\":1,\"tid\":6") == 1);
+    assert(count_matches(json, "\"ph\":\"X\"") == 4);
+    assert(count_matches(json, "\"name\":\"queue 0xabc0\",\"ph\":\"C\"") == 2);
+    assert(count_matches(json, "\"name\":\"create\"") == 1);
+    free(json);
+    
+    assert(trace_export_chrome("/nonexistent/trace.bin", stdout) == false);
+    printf("✓ test_trace_export_chrome passed\n");
+}
+
+void test_trace_instrumentation(void) {
+    queue_t queue;
+    uint8_t item;
+    
+    trace_clear();
+    task_manager_init();
+    queue_init(&queue, 4);
+    assert(task_create(1, "Traced", 2, 0) == true);
+    assert(task_set_state(1, TASK_RUNNING) == true);
+    assert(queue_enqueue(&queue, 9) == true);
+    assert(queue_dequeue(&queue, &item) == true);
+    assert(task_delete(1) == true);
+    assert(trace_dump(trace_path) == true);
+    
+#ifdef TRACE
+    char* json = export_json();
+    assert(count_matches(json, "\"name\":\"task 1\"") == 1);
+    assert(count_matches(json, "\"name\":\"RUNNING\",\"ph\":\"X\",\"pid\":1,\"tid\":1") == 1);
+    assert(count_matches(json, "\"ph\":\"C\"") == 2);
+    free(json);
+#else
+    // Compiled out: nothing is recorded
+    assert(read_dump(trace_path).records == 0);
+#endif
+    printf("✓ test_trace_instrumentation passed\n");
+}
+
+int main(void) {
+    printf("Running trace tests...\n");
+    snprintf(trace_path, sizeof(trace_path), "/tmp/test_trace_%ld.bin", (long)getpid());
+    
+    test_trace_per_thread_rings();
+    test_trace_reuses_exited_thread_rings();
+    test_trace_ring_overwrites_oldest();
+    test_trace_export_chrome();
+    test_trace_instrumentation();
+    
+    unlink(trace_path);
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,89 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <assert.h>
+#include <time.h>
+#include "ttl_queue.h"
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// Test cases
+void test_ttl_queue_skips_expired(void) {
+    ttl_queue_t queue;
+    uint8_t item;
+    
+    ttl_queue_init(&queue, 8, 50000);
+    assert(ttl_queue_enqueue(&queue, 1) == true);
+    assert(ttl_queue_enqueue(&queue, 2) == true);
+    assert(ttl_queue_enqueue_ttl(&queue, 3, TTL_NEVER) == true);
+    sleep_ms(60);
+    assert(ttl_queue_enqueue(&queue, 4) == true);
+    
+    // Items 1 and 2 are stale and silently skipped
+    assert(ttl_queue_dequeue(&queue, &item) == true && item == 3);
+    assert(ttl_queue_expired(&queue) == 2);
+    assert(ttl_queue_dequeue(&queue, &item) == true && item == 4);
+    assert(ttl_queue_dequeue(&queue, &item) == false);
+    
+    printf("✓ test_ttl_queue_skips_expired passed\n");
+}
+
+void test_ttl_queue_purge(void) {
+    ttl_queue_t queue;
+    uint8_t item;
+    
+    ttl_queue_init(&queue, 8, 50000);
+    for (uint8_t i = 0; i < 6; i++) {
+        ttl_queue_enqueue(&queue, i);
+    }
+    sleep_ms(60);
+    ttl_queue_enqueue(&queue, 6);
+    ttl_queue_enqueue(&queue, 7);
+    assert(ttl_queue_size(&queue) == 8);
+    
+    // A full queue makes room by dropping expired items
+    assert(ttl_queue_enqueue(&queue, 8) == true);
+    assert(ttl_queue_size(&queue) == 3);
+    assert(ttl_queue_expired(&queue) == 6);
+    assert(ttl_queue_purge(&queue) == 0);
+    
+    sleep_ms(60);
+    assert(ttl_queue_purge(&queue) == 3);
+    assert(ttl_queue_dequeue(&queue, &item) == false);
+    assert(ttl_queue_expired(&queue) == 9);
+    
+    printf("✓ test_ttl_queue_purge passed\n");
+}
+
+void test_ttl_queue_mixed_ttls(void) {
+    ttl_queue_t queue;
+    uint8_t item;
+    
+    ttl_queue_init(&queue, 8, TTL_NEVER);
+    ttl_queue_enqueue_ttl(&queue, 1, 1000);
+    ttl_queue_enqueue(&queue, 2);
+    ttl_queue_enqueue_ttl(&queue, 3, 1000);
+    sleep_ms(5);
+    
+    // Purge stops at the first live item; later stale items go lazily
+    assert(ttl_queue_purge(&queue) == 1);
+    assert(ttl_queue_dequeue(&queue, &item) == true && item == 2);
+    assert(ttl_queue_dequeue(&queue, &item) == false);
+    assert(ttl_queue_expired(&queue) == 2);
+    
+    printf("✓ test_ttl_queue_mixed_ttls passed\n");
+}
+
+int main(void) {
+    printf("Running TTL queue tests...\n");
+    
+    test_ttl_queue_skips_expired();
+    test_ttl_queue_purge();
+    test_ttl_queue_mixed_ttls();
+    
+    printf("\nAll tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,52 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "timeout.h"
+#include "task_manager.h"
+#include <errno.h>
+
+void timeout_cond_init(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// Waits on cond until ready(ctx) holds or the timeout expires. Called with
+// lock held. The calling task, if any, is shown as TASK_BLOCKED while it is
+// parked and as TASK_RUNNING once it resumes, unless another thread moved it
+// out of TASK_BLOCKED meanwhile (e.g. suspended it).
+bool timeout_wait(pthread_cond_t* cond, pthread_mutex_t* lock, uint32_t timeout_ms,
+                  bool (*ready)(const void* ctx), const void* ctx) {
+    if (ready(ctx)) {
+        return true;
+    }
+    if (timeout_ms == QUEUE_NO_WAIT) {
+        return false;
+    }
+    
+    struct timespec deadline;
+    if (timeout_ms != QUEUE_WAIT_FOREVER) {
+        timeout_to_deadline(&deadline, timeout_ms);
+    }
+    
+    uint32_t task_id;
+    bool has_task = task_get_current(&task_id);
+    if (has_task) {
+        task_set_state(task_id, TASK_BLOCKED);
+    }
+    
+    int rc = 0;
+    while (!ready(ctx) && rc != ETIMEDOUT) {
+        if (timeout_ms == QUEUE_WAIT_FOREVER) {
+            rc = pthread_cond_wait(cond, lock);
+        } else {
+            rc = pthread_cond_timedwait(cond, lock, &deadline);
+        }
+    }
+    
+    if (has_task) {
+        task_set_state_if(task_id, TASK_BLOCKED, TASK_RUNNING);
+    }
+    return ready(ctx);
+}
@@ -0,0 +1,30 @@
+#ifndef TIMEOUT_H
+#define TIMEOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+
+// Timeout values, in milliseconds (one tick == 1 ms)
+#define QUEUE_NO_WAIT      0u
+#define QUEUE_WAIT_FOREVER UINT32_MAX
+
+// Absolute CLOCK_MONOTONIC deadline timeout_ms from now, for use with
+// pthread_cond_timedwait on condition variables bound to CLOCK_MONOTONIC.
+static inline void timeout_to_deadline(struct timespec* deadline, uint32_t timeout_ms) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+// Function declarations
+void timeout_cond_init(pthread_cond_t* cond);
+bool timeout_wait(pthread_cond_t* cond, pthread_mutex_t* lock, uint32_t timeout_ms,
+                  bool (*ready)(const void* ctx), const void* ctx);
+
+#endif // TIMEOUT_H
@@ -0,0 +1,29 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "timestamp.h"
+#include <pthread.h>
+
+uint64_t timestamp_tick_scale = 1ull << 32;
+
+static pthread_once_t calibrate_once = PTHREAD_ONCE_INIT;
+
+// Measures the tick rate against CLOCK_MONOTONIC over about a millisecond
+static void timestamp_calibrate(void) {
+#if TIMESTAMP_HAS_TSC
+    uint64_t ns_start = timestamp_now_ns();
+    uint64_t ticks_start = timestamp_now_ticks();
+    uint64_t ns_end;
+    do {
+        ns_end = timestamp_now_ns();
+    } while (ns_end - ns_start < 1000000u);
+    uint64_t ticks = timestamp_now_ticks() - ticks_start;
+    
+    if (ticks > 0) {
+        timestamp_tick_scale = ((ns_end - ns_start) << 32) / ticks;
+    }
+#endif
+}
+
+void timestamp_init(void) {
+    pthread_once(&calibrate_once, timestamp_calibrate);
+}
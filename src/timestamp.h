@@ -0,0 +1,50 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TIMESTAMP_HAS_TSC 1
+#else
+#define TIMESTAMP_HAS_TSC 0
+#endif
+
+// Nanoseconds per tick in 32.32 fixed point, set by timestamp_init()
+extern uint64_t timestamp_tick_scale;
+
+// Monotonic nanosecond clock. clock_gettime(CLOCK_MONOTONIC) is served
+// from the vDSO on Linux, so this does not enter the kernel.
+static inline uint64_t timestamp_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Cheapest available timestamp for hot paths: the TSC on x86, otherwise
+// the nanosecond clock. Convert differences with timestamp_ticks_to_ns().
+static inline uint64_t timestamp_now_ticks(void) {
+#if TIMESTAMP_HAS_TSC
+    return __builtin_ia32_rdtsc();
+#else
+    return timestamp_now_ns();
+#endif
+}
+
+// (ticks * scale) >> 32 for a 32.32 fixed-point scale, split into 32-bit
+// halves so it needs no 128-bit type (i386 has the TSC but no __int128)
+static inline uint64_t timestamp_scale_ticks(uint64_t ticks, uint64_t scale) {
+    uint64_t ticks_hi = ticks >> 32, ticks_lo = ticks & 0xffffffffu;
+    uint64_t scale_hi = scale >> 32, scale_lo = scale & 0xffffffffu;
+    return ((ticks_hi * scale_hi) << 32) + ticks_hi * scale_lo + ticks_lo * scale_hi +
+           ((ticks_lo * scale_lo) >> 32);
+}
+
+static inline uint64_t timestamp_ticks_to_ns(uint64_t ticks) {
+    return timestamp_scale_ticks(ticks, timestamp_tick_scale);
+}
+
+// Function declarations
+void timestamp_init(void);
+
+#endif // TIMESTAMP_H
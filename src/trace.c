@@ -0,0 +1,375 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace.h"
+#include "task_manager.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define TASK_MAP_MIN_SIZE 64
+
+__thread trace_ring_t* trace_thread_ring = NULL;
+
+// Rings are pushed at the head and never freed, so the list can be walked
+// without the lock once its head has been read. A thread's ring is
+// orphaned when it exits and becomes free for a new thread once a dump
+// has written it, so the list only grows with the number of live threads
+// plus exited ones not yet dumped.
+static trace_ring_t* rings = NULL;
+static uint32_t ring_count = 0;
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+// Runs in the owning thread as it exits. Records from later destructors
+// attach a fresh ring rather than write to one that may be handed on.
+static void ring_orphan(void* ring) {
+    trace_thread_ring = NULL;
+    __atomic_store_n(&((trace_ring_t*)ring)->state, TRACE_RING_ORPHANED, __ATOMIC_RELEASE);
+}
+
+static void ring_key_create(void) {
+    pthread_key_create(&ring_key, ring_orphan);
+}
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t tick_scale;
+    uint32_t ring_count;
+    uint32_t reserved;
+} trace_file_header_t;
+
+typedef struct {
+    uint32_t thread_index;
+    uint32_t record_count;
+} trace_file_ring_t;
+
+// First record of a thread: takes a free ring or allocates one. The ring
+// outlives the thread so its history can still be dumped.
+trace_ring_t* trace_ring_attach(void) {
+    pthread_once(&ring_key_once, ring_key_create);
+    timestamp_init();
+    
+    pthread_mutex_lock(&rings_lock);
+    trace_ring_t* ring = rings;
+    while (ring && __atomic_load_n(&ring->state, __ATOMIC_RELAXED) != TRACE_RING_FREE) {
+        ring = ring->next;
+    }
+    if (ring) {
+        __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+        ring->state = TRACE_RING_ACTIVE;
+    } else {
+        ring = calloc(1, sizeof(trace_ring_t));
+        if (!ring) {
+            pthread_mutex_unlock(&rings_lock);
+            return NULL;
+        }
+        ring->next = rings;
+        __atomic_store_n(&rings, ring, __ATOMIC_RELEASE);
+    }
+    ring->thread_index = ring_count++;
+    pthread_mutex_unlock(&rings_lock);
+    pthread_setspecific(ring_key, ring);
+    trace_thread_ring = ring;
+    return ring;
+}
+
+// Forgets all recorded events. Only safe while no thread is recording.
+void trace_clear(void) {
+    for (trace_ring_t* ring = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        __atomic_store_n(&ring->head, 0, __ATOMIC_RELEASE);
+    }
+}
+
+// Copies the readable part of a ring into records and returns the count.
+// Records the owner may have overwritten during the copy are dropped.
+static uint32_t ring_snapshot(trace_ring_t* ring, trace_record_t* records) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t start = head > TRACE_RING_RECORDS ? head - TRACE_RING_RECORDS : 0;
+    for (uint64_t i = start; i < head; i++) {
+        records[i - start] = ring->records[i & (TRACE_RING_RECORDS - 1)];
+    }
+    
+    // The slot being written next holds index head_after - RING_RECORDS
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t head_after = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint64_t valid = head_after >= TRACE_RING_RECORDS ? head_after - TRACE_RING_RECORDS + 1 : 0;
+    if (valid > head) {
+        return 0;
+    }
+    if (valid > start) {
+        memmove(records, records + (valid - start), (size_t)(head - valid) * sizeof(*records));
+        start = valid;
+    }
+    return (uint32_t)(head - start);
+}
+
+// Writes every thread's ring to path. Threads keep recording meanwhile.
+bool trace_dump(const char* path) {
+    if (!path) {
+        return false;
+    }
+    trace_record_t* records = malloc(TRACE_RING_RECORDS * sizeof(trace_record_t));
+    FILE* file = fopen(path, "wb");
+    if (!records || !file) {
+        free(records);
+        if (file) {
+            fclose(file);
+        }
+        return false;
+    }
+    timestamp_init();
+    
+    // rings_lock keeps free rings from being taken mid-dump; threads that
+    // already have a ring record on meanwhile
+    pthread_mutex_lock(&rings_lock);
+    trace_file_header_t header = { TRACE_MAGIC, TRACE_VERSION, timestamp_tick_scale, 0, 0 };
+    for (trace_ring_t* ring = rings; ring; ring = ring->next) {
+        header.ring_count += __atomic_load_n(&ring->state, __ATOMIC_RELAXED) != TRACE_RING_FREE;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    
+    for (trace_ring_t* ring = rings; ring && ok; ring = ring->next) {
+        // Checked before the copy: an orphaned ring is complete
+        uint32_t state = __atomic_load_n(&ring->state, __ATOMIC_ACQUIRE);
+        if (state == TRACE_RING_FREE) {
+            continue;
+        }
+        trace_file_ring_t entry = { ring->thread_index, ring_snapshot(ring, records) };
+        ok = fwrite(&entry, sizeof(entry), 1, file) == 1 &&
+             fwrite(records, sizeof(trace_record_t), entry.record_count, file) == entry.record_count;
+        if (ok && state == TRACE_RING_ORPHANED) {
+            ring->state = TRACE_RING_FREE;
+        }
+    }
+    pthread_mutex_unlock(&rings_lock);
+    ok = fclose(file) == 0 && ok;
+    free(records);
+    return ok;
+}
+
+// Chrome trace export
+
+typedef struct {
+    trace_record_t record;
+    uint32_t thread_index;
+    uint32_t order;
+} trace_event_entry_t;
+
+typedef struct {
+    uint64_t task_id;
+    uint64_t since;
+    uint32_t state;
+    bool used;
+    bool open;
+} task_track_t;
+
+typedef struct {
+    task_track_t* slots;
+    uint32_t mask;
+    uint32_t count;
+} task_map_t;
+
+static const char* const state_names[TASK_STATE_COUNT] = {
+    "READY", "RUNNING", "BLOCKED", "SUSPENDED"
+};
+
+static int entry_compare(const void* a, const void* b) {
+    const trace_event_entry_t* x = a;
+    const trace_event_entry_t* y = b;
+    if (x->record.ticks != y->record.ticks) {
+        return x->record.ticks < y->record.ticks ? -1 : 1;
+    }
+    return x->order < y->order ? -1 : (x->order > y->order);
+}
+
+static uint32_t task_map_hash(uint64_t id, uint32_t mask) {
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+static task_track_t* task_map_slot(task_map_t* map, uint64_t id) {
+    uint32_t pos = task_map_hash(id, map->mask);
+    while (map->slots[pos].used && map->slots[pos].task_id != id) {
+        pos = (pos + 1) & map->mask;
+    }
+    return &map->slots[pos];
+}
+
+// Returns the track for id, adding it if new; NULL if out of memory
+static task_track_t* task_map_get(task_map_t* map, uint64_t id, bool* added) {
+    if (2 * (map->count + 1) > map->mask + 1) {
+        uint32_t size = 2 * (map->mask + 1);
+        task_map_t grown = { calloc(size, sizeof(task_track_t)), size - 1, map->count };
+        if (!grown.slots) {
+            return NULL;
+        }
+        for (uint32_t i = 0; i <= map->mask; i++) {
+            if (map->slots[i].used) {
+                *task_map_slot(&grown, map->slots[i].task_id) = map->slots[i];
+            }
+        }
+        free(map->slots);
+        *map = grown;
+    }
+    task_track_t* track = task_map_slot(map, id);
+    *added = !track->used;
+    if (!track->used) {
+        memset(track, 0, sizeof(*track));
+        track->used = true;
+        track->task_id = id;
+        map->count++;
+    }
+    return track;
+}
+
+static double ticks_to_us(uint64_t ticks, uint64_t scale) {
+    return (double)timestamp_scale_ticks(ticks, scale) / 1000.0;
+}
+
+static void emit_separator(FILE* out, bool* first) {
+    fputs(*first ? "\n" : ",\n", out);
+    *first = false;
+}
+
+static void emit_state_span(FILE* out, bool* first, const task_track_t* track,
+                            uint64_t end, uint64_t base, uint64_t scale) {
+    emit_separator(out, first);
+    fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%llu,"
+                 "\"ts\":%.3f,\"dur\":%.3f}",
+            track->state < TASK_STATE_COUNT ? state_names[track->state] : "UNKNOWN",
+            (unsigned long long)track->task_id, ticks_to_us(track->since - base, scale),
+            ticks_to_us(end - track->since, scale));
+}
+
+static trace_event_entry_t* load_events(FILE* in, uint64_t* scale, uint32_t* count) {
+    trace_file_header_t header;
+    if (fread(&header, sizeof(header), 1, in) != 1 ||
+        header.magic != TRACE_MAGIC || header.version != TRACE_VERSION) {
+        return NULL;
+    }
+    *scale = header.tick_scale;
+    
+    trace_event_entry_t* events = NULL;
+    uint32_t total = 0;
+    for (uint32_t r = 0; r < header.ring_count; r++) {
+        trace_file_ring_t entry;
+        if (fread(&entry, sizeof(entry), 1, in) != 1 || entry.record_count > TRACE_RING_RECORDS) {
+            free(events);
+            return NULL;
+        }
+        trace_event_entry_t* grown = realloc(events, ((size_t)total + entry.record_count + 1) *
+                                                     sizeof(*events));
+        if (!grown) {
+            free(events);
+            return NULL;
+        }
+        events = grown;
+        for (uint32_t i = 0; i < entry.record_count; i++) {
+            trace_event_entry_t* event = &events[total];
+            if (fread(&event->record, sizeof(trace_record_t), 1, in) != 1) {
+                free(events);
+                return NULL;
+            }
+            event->thread_index = entry.thread_index;
+            event->order = total++;
+        }
+    }
+    *count = total;
+    return events ? events : malloc(sizeof(*events));
+}
+
+// Converts a trace_dump file to Chrome trace JSON: process 1 holds one
+// track per task with a span for each state it was in, process 2 one
+// depth counter per queue
+bool trace_export_chrome(const char* trace_path, FILE* out) {
+    if (!trace_path || !out) {
+        return false;
+    }
+    FILE* in = fopen(trace_path, "rb");
+    if (!in) {
+        return false;
+    }
+    uint64_t scale = 0;
+    uint32_t count = 0;
+    trace_event_entry_t* events = load_events(in, &scale, &count);
+    fclose(in);
+    task_map_t map = { calloc(TASK_MAP_MIN_SIZE, sizeof(task_track_t)), TASK_MAP_MIN_SIZE - 1, 0 };
+    if (!events || !map.slots) {
+        free(events);
+        free(map.slots);
+        return false;
+    }
+    qsort(events, count, sizeof(*events), entry_compare);
+    
+    uint64_t base = count ? events[0].record.ticks : 0;
+    uint64_t last = base;
+    bool first = true;
+    bool ok = true;
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+    emit_separator(out, &first);
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Tasks\"}},\n"
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"Queues\"}}", out);
+    
+    for (uint32_t i = 0; i < count && ok; i++) {
+        const trace_record_t* record = &events[i].record;
+        double ts = ticks_to_us(record->ticks - base, scale);
+        last = record->ticks;
+    
+        if (record->type == TRACE_QUEUE_ENQUEUE || record->type == TRACE_QUEUE_DEQUEUE) {
+            emit_separator(out, &first);
+            fprintf(out, "{\"name\":\"queue 0x%llx\",\"ph\":\"C\",\"pid\":2,\"ts\":%.3f,"
+                         "\"args\":{\"depth\":%u}}",
+                    (unsigned long long)record->object, ts, record->value);
+            continue;
+        }
+        if (record->type != TRACE_TASK_CREATE && record->type != TRACE_TASK_DELETE &&
+            record->type != TRACE_TASK_STATE) {
+            continue;
+        }
+    
+        bool added = false;
+        task_track_t* track = task_map_get(&map, record->object, &added);
+        if (!track) {
+            ok = false;
+            break;
+        }
+        if (added) {
+            emit_separator(out, &first);
+            fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,"
+                         "\"args\":{\"name\":\"task %llu\"}}",
+                    (unsigned long long)record->object, (unsigned long long)record->object);
+        }
+    
+        uint32_t state = record->type == TRACE_TASK_CREATE ? (uint32_t)TASK_READY : record->value;
+        if (track->open && (record->type != TRACE_TASK_STATE || state != track->state)) {
+            emit_state_span(out, &first, track, record->ticks, base, scale);
+            track->open = false;
+        }
+        if (record->type == TRACE_TASK_DELETE) {
+            continue;
+        }
+        if (!track->open) {
+            track->open = true;
+            track->state = state;
+            track->since = record->ticks;
+        }
+        if (record->type == TRACE_TASK_CREATE) {
+            emit_separator(out, &first);
+            fprintf(out, "{\"name\":\"create\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%llu,"
+                         "\"ts\":%.3f,\"args\":{\"priority\":%u,\"thread\":%u}}",
+                    (unsigned long long)record->object, ts, record->value, events[i].thread_index);
+        }
+    }
+    
+    // Tasks still alive at the end of the trace
+    for (uint32_t i = 0; i <= map.mask && ok; i++) {
+        if (map.slots[i].used && map.slots[i].open) {
+            emit_state_span(out, &first, &map.slots[i], last, base, scale);
+        }
+    }
+    fputs("\n]}\n", out);
+    free(events);
+    free(map.slots);
+    return ok && !ferror(out);
+}
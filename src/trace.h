@@ -0,0 +1,89 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "timestamp.h"
+
+// Binary event trace of the task manager and queues, compiled in only
+// with -DTRACE (make TRACE=1). Each thread records into its own ring of
+// TRACE_RING_RECORDS fixed-size records, so recording takes no lock and
+// no atomic read-modify-write: a timestamp, three stores and a release
+// store of the ring head. Full rings overwrite their oldest records,
+// keeping the most recent history like a flight recorder.
+//
+// Rings are reused rather than freed: an exited thread's ring goes to the
+// next new thread once trace_dump() has written it.
+//
+// trace_dump() writes every ring to a file while threads keep recording;
+// trace_export_chrome() (and tools/trace2json) turns that file into
+// Chrome trace JSON, viewable in Perfetto or chrome://tracing, with one
+// state timeline per task and a depth counter per queue.
+
+#define TRACE_RING_RECORDS 65536   // per thread, power of two
+#define TRACE_MAGIC        0x45435254u   // "TRCE"
+#define TRACE_VERSION      1u
+
+typedef enum {
+    TRACE_TASK_CREATE = 1,   // object: task id, value: priority
+    TRACE_TASK_DELETE,       // object: task id
+    TRACE_TASK_STATE,        // object: task id, value: new task_state_t
+    TRACE_QUEUE_ENQUEUE,     // object: queue address, value: count after
+    TRACE_QUEUE_DEQUEUE      // object: queue address, value: count after
+} trace_event_t;
+
+typedef struct {
+    uint64_t ticks;          // timestamp_now_ticks()
+    uint64_t object;
+    uint32_t value;
+    uint32_t type;
+} trace_record_t;
+
+typedef enum {
+    TRACE_RING_ACTIVE = 0,   // owned by a live thread
+    TRACE_RING_ORPHANED,     // owner exited, history not dumped yet
+    TRACE_RING_FREE          // dumped, reusable by a new thread
+} trace_ring_state_t;
+
+typedef struct trace_ring {
+    uint64_t head __attribute__((aligned(64)));   // records ever written
+    uint32_t thread_index;
+    uint32_t state;          // trace_ring_state_t
+    struct trace_ring* next;
+    trace_record_t records[TRACE_RING_RECORDS];
+} trace_ring_t;
+
+extern __thread trace_ring_t* trace_thread_ring;
+
+// Function declarations
+trace_ring_t* trace_ring_attach(void);
+bool trace_dump(const char* path);
+void trace_clear(void);
+bool trace_export_chrome(const char* trace_path, FILE* out);
+
+static inline void trace_record(trace_event_t type, uint64_t object, uint32_t value) {
+    trace_ring_t* ring = trace_thread_ring;
+    if (!ring) {
+        ring = trace_ring_attach();
+        if (!ring) {
+            return;
+        }
+    }
+    uint64_t head = ring->head;
+    trace_record_t* record = &ring->records[head & (TRACE_RING_RECORDS - 1)];
+    record->ticks = timestamp_now_ticks();
+    record->object = object;
+    record->value = value;
+    record->type = (uint32_t)type;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+#ifdef TRACE
+#define TRACE_EVENT(type, object, value) \
+    trace_record((type), (uint64_t)(object), (uint32_t)(value))
+#else
+#define TRACE_EVENT(type, object, value) ((void)0)
+#endif
+
+#endif // TRACE_H
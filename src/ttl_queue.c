@@ -0,0 +1,127 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "ttl_queue.h"
+#include "timestamp.h"
+
+#define EXPIRES_NEVER UINT64_MAX
+
+static const ttl_entry_t* entry_at(const ttl_queue_t* queue, uint32_t offset) {
+    return &queue->entries[(queue->head + offset) % queue->max_size];
+}
+
+static void drop_head(ttl_queue_t* queue, uint32_t n) {
+    queue->head = (queue->head + n) % queue->max_size;
+    queue->count -= n;
+    queue->expired += n;
+}
+
+// Number of expired entries at the front of the queue
+static uint32_t expired_prefix(const ttl_queue_t* queue, uint64_t now) {
+    if (queue->expiry_ordered) {
+        uint32_t lo = 0;
+        uint32_t hi = queue->count;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (entry_at(queue, mid)->expires_ns <= now) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+    
+    uint32_t n = 0;
+    while (n < queue->count && entry_at(queue, n)->expires_ns <= now) {
+        n++;
+    }
+    return n;
+}
+
+void ttl_queue_init(ttl_queue_t* queue, uint32_t size, uint32_t default_ttl_us) {
+    if (!queue || size == 0 || size > QUEUE_MAX_SIZE) {
+        return;
+    }
+    
+    queue->head = 0;
+    queue->tail = 0;
+    queue->count = 0;
+    queue->max_size = size;
+    queue->default_ttl_ns = (uint64_t)default_ttl_us * 1000u;
+    queue->last_expiry_ns = 0;
+    queue->expiry_ordered = true;
+    queue->expired = 0;
+}
+
+bool ttl_queue_enqueue(ttl_queue_t* queue, uint8_t item) {
+    if (!queue) {
+        return false;
+    }
+    return ttl_queue_enqueue_ttl(queue, item, (uint32_t)(queue->default_ttl_ns / 1000u));
+}
+
+bool ttl_queue_enqueue_ttl(ttl_queue_t* queue, uint8_t item, uint32_t ttl_us) {
+    if (!queue) {
+        return false;
+    }
+    
+    uint64_t now = timestamp_now_ns();
+    if (queue->count >= queue->max_size) {
+        // Make room by discarding whatever has already expired
+        drop_head(queue, expired_prefix(queue, now));
+        if (queue->count >= queue->max_size) {
+            return false;
+        }
+    }
+    
+    uint64_t expires = (ttl_us == TTL_NEVER) ? EXPIRES_NEVER : now + (uint64_t)ttl_us * 1000u;
+    if (queue->count == 0) {
+        queue->expiry_ordered = true;
+    } else if (expires < queue->last_expiry_ns) {
+        queue->expiry_ordered = false;
+    }
+    queue->last_expiry_ns = expires;
+    
+    queue->entries[queue->tail].item = item;
+    queue->entries[queue->tail].expires_ns = expires;
+    queue->tail = (queue->tail + 1) % queue->max_size;
+    queue->count++;
+    return true;
+}
+
+bool ttl_queue_dequeue(ttl_queue_t* queue, uint8_t* item) {
+    if (!queue || !item) {
+        return false;
+    }
+    
+    uint64_t now = timestamp_now_ns();
+    while (queue->count > 0) {
+        const ttl_entry_t* entry = &queue->entries[queue->head];
+        if (entry->expires_ns > now) {
+            *item = entry->item;
+            queue->head = (queue->head + 1) % queue->max_size;
+            queue->count--;
+            return true;
+        }
+        drop_head(queue, 1);
+    }
+    return false;
+}
+
+uint32_t ttl_queue_purge(ttl_queue_t* queue) {
+    if (!queue || queue->count == 0) {
+        return 0;
+    }
+    
+    uint32_t n = expired_prefix(queue, timestamp_now_ns());
+    drop_head(queue, n);
+    return n;
+}
+
+uint32_t ttl_queue_size(const ttl_queue_t* queue) {
+    return queue ? queue->count : 0;
+}
+
+uint32_t ttl_queue_expired(const ttl_queue_t* queue) {
+    return queue ? queue->expired : 0;
+}
@@ -0,0 +1,40 @@
+#ifndef TTL_QUEUE_H
+#define TTL_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "queue.h"
+
+#define TTL_NEVER 0u
+
+typedef struct {
+    uint8_t item;
+    uint64_t expires_ns;
+} ttl_entry_t;
+
+// Circular queue whose items carry an expiry time. Expired items are never
+// handed out: dequeue skips them lazily and purge drops an expired prefix
+// by moving head. While every item shares the same TTL the entries are in
+// expiry order and purge finds the cut with a binary search.
+typedef struct {
+    ttl_entry_t entries[QUEUE_MAX_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t count;
+    uint32_t max_size;
+    uint64_t default_ttl_ns;
+    uint64_t last_expiry_ns;
+    bool expiry_ordered;
+    uint32_t expired;
+} ttl_queue_t;
+
+// Function declarations
+void ttl_queue_init(ttl_queue_t* queue, uint32_t size, uint32_t default_ttl_us);
+bool ttl_queue_enqueue(ttl_queue_t* queue, uint8_t item);
+bool ttl_queue_enqueue_ttl(ttl_queue_t* queue, uint8_t item, uint32_t ttl_us);
+bool ttl_queue_dequeue(ttl_queue_t* queue, uint8_t* item);
+uint32_t ttl_queue_purge(ttl_queue_t* queue);
+uint32_t ttl_queue_size(const ttl_queue_t* queue);
+uint32_t ttl_queue_expired(const ttl_queue_t* queue);
+
+#endif // TTL_QUEUE_H
@@ -0,0 +1,28 @@
+#include <stdio.h>
+#include "metrics_page.h"
+
+// Prints a metrics page in Prometheus text format, e.g. for a
+// node_exporter textfile collector or a scrape wrapper.
+//
+//   metrics_dump /my_app_metrics
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <shm name>\n", argv[0]);
+        return 2;
+    }
+    
+    metrics_page_t metrics;
+    if (!metrics_page_attach(&metrics, argv[1])) {
+        fprintf(stderr, "%s: cannot attach %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    
+    metrics_snapshot_t snapshot;
+    bool ok = metrics_page_read(&metrics, &snapshot) && metrics_write_prometheus(&snapshot, stdout);
+    metrics_page_detach(&metrics);
+    if (!ok) {
+        fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include <stdio.h>
+#include "trace.h"
+
+// Converts a trace_dump() file to Chrome trace JSON for Perfetto
+// (ui.perfetto.dev) or chrome://tracing.
+//
+//   trace2json trace.bin > trace.json
+//   trace2json trace.bin trace.json
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <trace.bin> [trace.json]\n", argv[0]);
+        return 2;
+    }
+    
+    FILE* out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+    bool ok = trace_export_chrome(argv[1], out);
+    if (out != stdout) {
+        ok = fclose(out) == 0 && ok;
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: cannot convert %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    return 0;
+}